@@ -0,0 +1,128 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <sys/resource.h>
+
+#include "Parser.h"
+#include "SATTypes.h"
+#include "Heuristics.h"
+
+thread_local std::map<unsigned int, double> Heuristic::heuristicValues;
+thread_local std::map<unsigned int, FixedPoint::Score> Heuristic::fixedPointValues;
+thread_local bool Heuristic::compareFixedPoint = false;
+
+//measures the initialization before the first decision with different numbers of threads (-it) on a random formula:
+//the occurence lists, the implication lists, the initial scores and the dynamic heuristics that are built from them.
+//Usage: initializationBenchmark [variables] [clauses] [threads...]
+
+std::vector<Cl> randomFormula(unsigned int nrVariables, std::size_t nrClauses) {
+    std::mt19937 random(1);
+    std::uniform_int_distribution<unsigned int> variable(1, nrVariables);
+    std::uniform_int_distribution<unsigned int> length(2, 6);
+    std::vector<Cl> clauses(nrClauses);
+
+    for (Cl& clause: clauses) {
+        for (unsigned int i = length(random); i > 0; i--) {
+            clause.addLiteral(Lit(variable(random), random() % 2 == 0));
+        }
+    }
+
+    return clauses;
+}
+
+double cpuSeconds() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+//the occurence lists as clause indices, to check that they do not depend on the number of threads
+std::vector<std::size_t> occurenceIndices(const std::vector<Var>& variables, const std::vector<Cl>& clauses) {
+    std::vector<std::size_t> indices;
+
+    for (const Var& var: variables) {
+        for (Cl* clause: var.posOccList) {
+            indices.push_back(clause - clauses.data());
+        }
+        indices.push_back(clauses.size());
+
+        for (Cl* clause: var.negOccList) {
+            indices.push_back(clause - clauses.data());
+        }
+        indices.push_back(clauses.size());
+    }
+
+    return indices;
+}
+
+int main(int argc, char** argv) {
+    unsigned int nrVariables = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    std::size_t nrClauses = argc > 2 ? std::stoull(argv[2]) : 4000000;
+    std::vector<unsigned int> threadCounts;
+
+    for (int i = 3; i < argc; i++) {
+        threadCounts.push_back(std::stoul(argv[i]));
+    }
+
+    if (threadCounts.empty()) {
+        threadCounts = {1, 2, 4, 8};
+    }
+
+    const std::vector<Cl> formula = randomFormula(nrVariables, nrClauses);
+    std::cout << nrVariables << " variables, " << nrClauses << " clauses, " << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    std::cout << "threads  occurences  implications  scores  heuristics  total  speedup  cpu" << std::endl;
+
+    std::vector<std::size_t> expectedIndices;
+    double sequentialTotal = 0;
+    int result = 0;
+
+    for (unsigned int nrThreads: threadCounts) {
+        std::vector<Cl> clauses = formula;
+        std::vector<Var> variables;
+        for (unsigned int i = 1; i <= nrVariables; i++) {
+            variables.push_back(Var(i));
+        }
+
+        double cpuStart = cpuSeconds();
+        std::vector<double> times;
+        auto last = std::chrono::steady_clock::now();
+        auto measure = [&]() {
+            auto now = std::chrono::steady_clock::now();
+            times.push_back(std::chrono::duration<double>(now - last).count());
+            last = now;
+        };
+
+        Parser::buildOccurenceLists(clauses, variables, nrThreads);
+        measure();
+        Parser::buildImplicationLists(variables, nrThreads);
+        measure();
+        InitialScores scores = InitialScores::compute(variables, clauses, nrThreads);
+        measure();
+        {
+            JeroslowWang<true> jeroslowWang(variables, &scores, false, nrThreads);
+            MomsFreeman<true> moms(variables, clauses, 10.0, &scores, nrThreads);
+            HybridHeuristic<true> hybrid(variables, 100, false, nrThreads);
+        }
+        measure();
+
+        double total = times[0] + times[1] + times[2] + times[3];
+        if (expectedIndices.empty()) {
+            expectedIndices = occurenceIndices(variables, clauses);
+            sequentialTotal = total;
+        } else if (occurenceIndices(variables, clauses) != expectedIndices) {
+            std::cerr << "The occurence lists with " << nrThreads << " threads differ from the lists of the first run." << std::endl;
+            result = 1;
+        }
+
+        std::cout << std::fixed << std::setprecision(2) << std::setw(7) << nrThreads;
+        for (double time: times) {
+            std::cout << "  " << std::setw(9) << time;
+        }
+        std::cout << "  " << std::setw(5) << total << "  " << std::setw(6) << sequentialTotal / total << "x  " << cpuSeconds() - cpuStart << std::endl;
+    }
+
+    return result;
+}
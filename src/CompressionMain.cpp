@@ -3,6 +3,9 @@
 #include <fstream>
 #include <filesystem>
 #include <chrono>
+#include <numeric>
+#include <algorithm>
+#include <optional>
 
 #include "Parser.h"
 #include "Propagation.h"
@@ -11,10 +14,27 @@
 #include "Output.h"
 #include "StringCompression.h"
 #include "BitvectorEncoding.h"
+#include "FormulaCache.h"
+#include "ParsedFormulaCache.h"
+#include "CompressionHeader.h"
+#include "Preprocessing.h"
+#include "Equivalences.h"
+#include "Components.h"
+#include "Renumbering.h"
+#include "Workspace.h"
+#include "BitSliced.h"
+#include "ReferenceModel.h"
+#include "PolarityPriors.h"
+#include "Portfolio.h"
+#include "Parallel.h"
+#include "ArchiveReader.h"
+#include "ModelContainer.h"
 
 namespace fs = std::filesystem;
 
-std::map<unsigned int, double> Heuristic::heuristicValues;
+thread_local std::map<unsigned int, double> Heuristic::heuristicValues;
+thread_local std::map<unsigned int, FixedPoint::Score> Heuristic::fixedPointValues;
+thread_local bool Heuristic::compareFixedPoint = false;
 
 struct CompressionSetup
 {
@@ -25,86 +45,140 @@ struct CompressionSetup
     unsigned int predictionFlip;
     unsigned int hybridHeuristicParam;
     bool disableFaithfulMode;
+    unsigned int parserThreads;
+    unsigned int initThreads;
+    std::string formulaCache;
+    bool fixedPointScores;
+    bool container;
+    bool preprocess;
+    bool rootPropagation;
+    bool substituteEquivalences;
+    bool components;
+    unsigned int componentThreads;
+    bool renumber;
+    bool bitSliced;
+    //name of the reference model in every instance directory, or the reference model file if a single model is compressed
+    std::string referenceModel;
+    //the reference of the instance of the current model, it is not set while the reference itself is compressed
+    std::shared_ptr<const ReferenceModel> reference;
+    //directory of the polarity priors of the instances, or the priors file if a single model is compressed
+    std::string priorsPath;
+    //the priors of the instance of the current model and their values with the ids of the prepared formula
+    std::shared_ptr<const PolarityPriors> priors;
+    const std::vector<Assignment>* priorValues;
+    //heuristics of the portfolio if the heuristic is chosen per model, the heuristic of the setup is then the heuristic of the current search
+    std::vector<std::string> portfolio;
+    unsigned int portfolioThreads;
+    //threads of the generic compression auto, zero uses one thread per codec
+    unsigned int codecThreads;
+
+    explicit CompressionSetup() : heuristic("jewa_dyn"), genericCompression("golrice"), momsParameter(10.0), golombRiceParameter(2), predictionFlip(5), hybridHeuristicParam(100), disableFaithfulMode(false), parserThreads(1), initThreads(1), formulaCache(""), fixedPointScores(false), container(false), preprocess(false), rootPropagation(false), substituteEquivalences(false), components(false), componentThreads(1), renumber(false), bitSliced(false), referenceModel(""), priorsPath(""), priorValues(nullptr), portfolioThreads(0), codecThreads(0) {}
+};
+
 
-    explicit CompressionSetup() : heuristic("jewa_dyn"), genericCompression("golrice"), momsParameter(10.0), golombRiceParameter(2), predictionFlip(5), hybridHeuristicParam(100), disableFaithfulMode(false) {}
+//statistics of the search, in the component mode they are summed over the components
+struct SearchInfo {
+    uint64_t bitvectorSize = 0;
+    uint64_t encodingSize = 0;
+    unsigned int propagatedDontCareVars = 0;
+    uint64_t predictionMisses = 0;
+    uint64_t nrPredictions = 0;
 };
 
+//compresses the encoding of the decisions with the codec
+std::string encodeDistances(const std::vector<uint32_t>& outputEncoding, const std::string& codec, unsigned int golombRiceParameter) {
+    std::string encoding;
+    std::vector<char> compressedEncoding;
 
-CompressionInfo compressModel(const char* formulaFile, const char* modelFile, const char* outputFile, CompressionSetup setup) {
-    //set start time
-    const auto startTime = std::chrono::high_resolution_clock::now();
+    //determine which generic compression algorith should be used 
+    if (codec == "golrice") {
+        compressedEncoding = StringCompression::golombRiceCompression(outputEncoding, golombRiceParameter);
+        encoding.append(compressedEncoding.begin(), compressedEncoding.end());
+    } else {
+        //convert the vector to a string
+        std::string outputString;
+        for (uint32_t value: outputEncoding) {
+            outputString.append(std::to_string(value));
+            outputString.append(" ");
+        }
+        //remove last whitespace
+        if (outputString.length() > 0) {
+            outputString.pop_back();
+        }
 
-    Parser parser(formulaFile, modelFile);
+        std::string compressedOutput;
 
-    std::cout << "Reading clauses" << std::endl;
-    std::vector<Cl> clauses = parser.readClauses();
-    std::vector<Var> variables = parser.readVariables();
-    std::cout << "Reading model" << std::endl;
-    std::map<unsigned int, ModelVar> model = parser.readModel();
+        if (codec == "zip") {
+            compressedOutput = StringCompression::compressString(outputString);
+        } else if (codec == "lz4") {
+            compressedOutput = StringCompression::lz4Compression(outputString);
+        } else {
+            throw std::runtime_error("Unknown compression algorithm: " + codec);
+        }
 
-    //measure parsing time
-    const auto parsingTime = std::chrono::high_resolution_clock::now();
+        encoding.append(compressedOutput);
+    }
 
-    std::cout << "Number of Variables: " << variables.size() << std::endl;
-    std::cout << "Number of Clauses: " << clauses.size() << std::endl;
-    std::cout << "Size of model: " << model.size() << std::endl;
+    return encoding;
+}
 
-    //correct the length of the variables vector if the model is bigger than the size of the variable vector
-    if (model.size() > variables.size()) {
-        int diff = model.size() - variables.size();
-        for (int i = 1; i <= diff; i++) {
-            variables.push_back(Var(variables.size() + i));
-        }
-        std::cout << "Corrected number of variables: " << variables.size() << std::endl;
+//encodes the bitvector of the decisions and the ids of the propagated don't care variables with the generic compression of the setup.
+//The generic compression auto compresses the encoding with all codecs and keeps the smallest result behind the id of its codec
+std::string encodeDecisions(const std::vector<bool>& bitvector, const std::vector<unsigned int>& dontCareVars, const CompressionSetup& setup, std::vector<uint32_t>& outputEncoding) {
+    outputEncoding.clear();
+    BitvectorEncoding::diffEncoding(bitvector, outputEncoding);
+
+    //append the ids of the propaged don't care variables
+    outputEncoding.insert(outputEncoding.end(), dontCareVars.begin(), dontCareVars.end());
+
+    if (setup.genericCompression != "auto") {
+        return encodeDistances(outputEncoding, setup.genericCompression, setup.golombRiceParameter);
     }
 
-    //build occurence list
-    for (Cl& clause: clauses) {
-        for (Lit lit: clause.literals) {
-            Var& var = variables.at(lit.id - 1);
+    const std::vector<std::string>& codecs = Portfolio::CODECS;
+    std::vector<std::string> encodings(codecs.size());
+    unsigned int nrThreads = setup.codecThreads == 0 ? codecs.size() : setup.codecThreads;
 
-            if (lit.negative) {
-                var.addNegClause(&clause);
-            } else {
-                var.addPosClause(&clause);
-            }
+    Parallel::forEach(codecs.size(), nrThreads, [&](std::size_t i) {
+        encodings[i] = encodeDistances(outputEncoding, codecs[i], setup.golombRiceParameter);
+    });
+
+    //the first codec wins a tie
+    std::size_t best = 0;
+    for (std::size_t i = 1; i < codecs.size(); i++) {
+        if (encodings[i].size() < encodings[best].size()) {
+            best = i;
         }
     }
 
-    Heuristic* heuristic;
+    return Portfolio::serializeCodec(codecs[best]) + encodings[best];
+}
 
+//searches the assignment of the model with the heuristic and returns the compressed encoding of the decisions.
+//The occurence and implication lists must be built and the values contain the assignments before the first decision
+template<class HeuristicType>
+std::string compressAssignment(std::vector<Cl>& clauses, std::vector<Var>& variables, const Model& model, std::vector<Assignment>& values, const CompressionSetup& setup,
+                               const InitialScores* scores, SearchBuffers& buffers, SearchInfo& info) {
     //create Heuristic object to sort the variables using a specific heuristic
-    if (setup.heuristic == "none") {
-        heuristic = new ParsingOrder(variables);
-    } else if (setup.heuristic == "jewa") {
-        heuristic = new JeroslowWang(variables, false);
-    } else if (setup.heuristic == "jewa_dyn") {
-        heuristic = new JeroslowWang(variables, true);
-    } else if (setup.heuristic == "moms") {
-        heuristic = new MomsFreeman(variables, clauses, false, setup.momsParameter);
-    } else if (setup.heuristic == "moms_dyn") {
-        heuristic = new MomsFreeman(variables, clauses, true, setup.momsParameter);
-    } else if (setup.heuristic == "hybr") {
-        heuristic = new HybridHeuristic(variables, false, setup.hybridHeuristicParam);
-    } else if (setup.heuristic == "hybr_dyn") {
-        heuristic = new HybridHeuristic(variables, true, setup.hybridHeuristicParam);
-    } else {
-        throw std::runtime_error("Unknown heuristic: " + setup.heuristic);
+    HeuristicType* heuristic = HeuristicType::create(variables, clauses, setup, scores);
+
+    if (setup.reference != nullptr) {
+        heuristic->setReference(&setup.reference->values);
     }
+    heuristic->setPriors(setup.priorValues);
 
-    //Heuristic* heuristic = new MomsFreeman(variables, clauses, true);
-    //Heuristic* heuristic = new JeroslowWang(variables, true);
-    std::vector<bool> bitvector;
+    buffers.clear();
+    std::vector<bool>& bitvector = buffers.bitvector;
     bool allSatisfied = false;
     uint64_t predictionMisses = 0;
     uint64_t nrPredictions = 0;
     uint64_t predictionDistance = 0;
     bool flipPredictionModel = false;
-    std::vector<unsigned int> dontCareVars;
+    std::vector<unsigned int>& dontCareVars = buffers.dontCareVars;
 
-    std::vector<Assignment> values(variables.size(), Assignment::OPEN);
-    std::vector<unsigned int> trail;
+    std::vector<unsigned int>& trail = buffers.trail;
     int head = 0;
+    std::size_t firstOpenClause = 0;
 
     while (!allSatisfied) {
         //get next value from the heuristic and assign it to the variable
@@ -117,12 +191,11 @@ CompressionInfo compressModel(const char* formulaFile, const char* modelFile, co
         }
 
         //if no model value exists for the variable it is assigned according to the prediction model
-        if (!model.count(nextVar.id)) {
+        if (!model.contains(nextVar.id)) {
             values[nextVar.id - 1] = heuristic->getPredictedAssignment(nextVar);
             dontCareVars.push_back(nextVar.id);
         } else {
-            ModelVar modelVar = model.at(nextVar.id);
-            values[modelVar.id - 1] = modelVar.assignment;
+            values[nextVar.id - 1] = model.get(nextVar.id);
         }
 
         trail.push_back(nextVar.id);
@@ -172,42 +245,30 @@ CompressionInfo compressModel(const char* formulaFile, const char* modelFile, co
 
         
         //check if all clauses are already satisfied
-        allSatisfied = true;
-
-        for (Cl clause: clauses) {
-            if (clause.literals.size() != 0) {
-                allSatisfied = false;
-                break;
-            }
+        //the clauses are only cleared during the search, so the check continues at the first clause that was not satisfied before
+        while (firstOpenClause < clauses.size() && clauses[firstOpenClause].literals.size() == 0) {
+            firstOpenClause++;
         }
+
+        allSatisfied = firstOpenClause == clauses.size();
     }
 
     unsigned int propagatedDontCareVars = dontCareVars.size();
 
     if ((!setup.disableFaithfulMode && nrPredictions != model.size()) || propagatedDontCareVars != 0) {
-        unsigned int nrPropagatedVars = nrPredictions;
-
-        //predict assignemts for the rest of the variables
+        //predict assignemts for the rest of the variables. Every open variable gets a bit, because the decompression
+        //reads one bit for every open variable until the heuristic has no variables left
         while (heuristic->hasNextVar()) {
-            //only push correct predictions if all model variables are already propagated
-            if ((nrPropagatedVars - dontCareVars.size()) == model.size()) {
-                bitvector.push_back(true);
-                continue;
-            }
-
             Var nextVar = heuristic->getNextVar();
 
-            nrPropagatedVars += 1;
-
             if (values[nextVar.id - 1] != Assignment::OPEN) {
                 continue;
             }
 
             Assignment prediction = heuristic->getPredictedAssignment(nextVar);
 
-            if (model.count(nextVar.id)) {
-                ModelVar modelVar = model.at(nextVar.id);
-                bitvector.push_back(modelVar.assignment == prediction);
+            if (model.contains(nextVar.id)) {
+                bitvector.push_back(model.get(nextVar.id) == prediction);
             } else {
                 bitvector.push_back(true);
                 dontCareVars.push_back(nextVar.id);
@@ -218,50 +279,321 @@ CompressionInfo compressModel(const char* formulaFile, const char* modelFile, co
     
     std::cout << "prediction flip: " << flipPredictionModel << std::endl; 
 
-    std::vector<uint32_t> outputEncoding = BitvectorEncoding::diffEncoding(bitvector);
+    std::vector<uint32_t>& outputEncoding = buffers.outputEncoding;
+    std::string encoding = encodeDecisions(bitvector, dontCareVars, setup, outputEncoding);
 
-    //append the ids of the propaged don't care variables
-    outputEncoding.insert(outputEncoding.end(), dontCareVars.begin(), dontCareVars.end());
-    
+    delete heuristic;
 
-    std::ofstream outputFileStream(outputFile);
+    info.bitvectorSize += bitvector.size();
+    info.encodingSize += outputEncoding.size();
+    info.propagatedDontCareVars += propagatedDontCareVars;
+    info.predictionMisses += predictionMisses;
+    info.nrPredictions += nrPredictions;
 
-    std::vector<char> compressedEncoding;
+    return encoding;
 
-    //determine which generic compression algorith should be used 
-    if (setup.genericCompression == "golrice") {
-        compressedEncoding = StringCompression::golombRiceCompression(outputEncoding, setup.golombRiceParameter);
+}
 
-        std::ostream_iterator<char> outputIterator(outputFileStream);
-        std::copy(compressedEncoding.begin(), compressedEncoding.end(), outputIterator);
-    } else {
-        //convert the vector to a string
-        std::string outputString;
-        for (uint32_t value: outputEncoding) {
-            outputString.append(std::to_string(value));
-            outputString.append(" ");
-        }
-        //remove last whitespace
-        if (outputString.length() > 0) {
-            outputString.pop_back();
+//compresses every component of the formula with its own heuristic, the components are independent so they are compressed in parallel.
+//Returns the component table followed by the compressed components
+template<class HeuristicType>
+std::string compressComponents(const std::vector<Cl>& clauses, unsigned int nrVariables, const Model& model, const std::vector<Assignment>& values, const CompressionSetup& setup, SearchInfo& info) {
+    std::vector<Components::Component> components = Components::split(clauses, nrVariables, values);
+    std::cout << "Number of components: " << components.size() << std::endl;
+
+    std::vector<std::string> encodings(components.size());
+    std::vector<SearchInfo> infos(components.size());
+
+    //the largest components are started first, so that the threads finish at about the same time
+    std::vector<std::size_t> order(components.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t x, std::size_t y) {
+        return components[x].clauses.size() > components[y].clauses.size();
+    });
+
+    //the threads are used for the components, so the initialization of every component is sequential
+    CompressionSetup componentSetup = setup;
+    if (setup.componentThreads > 1) {
+        componentSetup.initThreads = 1;
+    }
+
+    Parallel::forEach(order.size(), setup.componentThreads, [&](std::size_t i) {
+        std::size_t index = order[i];
+        Components::Component& component = components[index];
+
+        std::vector<Var> localVariables;
+        localVariables.reserve(component.variables.size());
+        for (unsigned int id = 1; id <= component.variables.size(); id++) {
+            localVariables.push_back(Var(id));
         }
 
-        std::string compressedOutput;
+        Parser::buildOccurenceLists(component.clauses, localVariables, 1);
+        Parser::buildImplicationLists(localVariables, 1);
 
-        if (setup.genericCompression == "zip") {
-            compressedOutput = StringCompression::compressString(outputString);
-        } else if (setup.genericCompression == "lz4") {
-            compressedOutput = StringCompression::lz4Compression(outputString);
+        Model localModel = Components::project(component, model);
+        std::vector<Assignment> localValues(component.variables.size(), Assignment::OPEN);
+        SearchBuffers buffers;
+
+        encodings[index] = compressAssignment<HeuristicType>(component.clauses, localVariables, localModel, localValues, componentSetup, nullptr, buffers, infos[index]);
+    });
+
+    for (const SearchInfo& componentInfo: infos) {
+        info.bitvectorSize += componentInfo.bitvectorSize;
+        info.encodingSize += componentInfo.encodingSize;
+        info.propagatedDontCareVars += componentInfo.propagatedDontCareVars;
+        info.predictionMisses += componentInfo.predictionMisses;
+        info.nrPredictions += componentInfo.nrPredictions;
+    }
+
+    return Components::serialize(encodings);
+}
+
+uint32_t compressionFlags(const CompressionSetup& setup) {
+    return (setup.preprocess ? CompressionHeader::PREPROCESSED : 0) | (setup.rootPropagation ? CompressionHeader::ROOT_PROPAGATION : 0)
+         | (setup.substituteEquivalences ? CompressionHeader::EQUIVALENT_LITERALS : 0) | (setup.components ? CompressionHeader::COMPONENTS : 0)
+         | (setup.renumber ? CompressionHeader::RENUMBERED : 0) | (!setup.referenceModel.empty() ? CompressionHeader::REFERENCE : 0)
+         | (!setup.priorsPath.empty() ? CompressionHeader::PRIORS : 0) | (!setup.portfolio.empty() ? CompressionHeader::HEURISTIC : 0)
+         | (setup.genericCompression == "auto" ? CompressionHeader::CODEC : 0) | (setup.fixedPointScores ? CompressionHeader::FIXED_POINT_SCORES : 0);
+}
+
+//returns the prepared formula and restores its clauses in the workspace if the workspace or the formula cache contains it.
+//The formula hash is only set if the formula cache is used, prepared formula is set if the workspace contains the clauses and the occurence lists
+std::shared_ptr<const ParsedFormula> loadFormula(const char* formulaFile, const CompressionSetup& setup, ParsedFormulaCache& parsedFormulas, Workspace& workspace,
+                                                 uint64_t& formulaHash, bool& preparedFormula) {
+    std::vector<Cl>& clauses = workspace.clauses;
+    std::vector<Var>& variables = workspace.variables;
+    std::shared_ptr<const ParsedFormula> formula;
+    uint32_t flags = compressionFlags(setup) & CompressionHeader::FORMULA_FLAGS;
+    preparedFormula = false;
+    formulaHash = 0;
+
+    //try to restore the parsed formula from the cache
+    if (!setup.formulaCache.empty()) {
+        formulaHash = FormulaCache::variantHash(parsedFormulas.contentHash(formulaFile), flags);
+        formula = workspace.find(formulaHash);
+
+        if (formula != nullptr) {
+            std::cout << "Reused the clauses of the last model" << std::endl;
+            preparedFormula = true;
         } else {
-            throw std::runtime_error("Unknown compression algorithm: " + setup.genericCompression);
+            FormulaCache cache(setup.formulaCache);
+            std::shared_ptr<ParsedFormula> cachedFormula = std::make_shared<ParsedFormula>();
+
+            if (cache.load(formulaHash, clauses, variables, workspace.initialScores, cachedFormula->rootLiterals, cachedFormula->substitutions, cachedFormula->originalIds)) {
+                std::cout << "Restored clauses from the formula cache" << std::endl;
+                cachedFormula->clauses = clauses;
+                cachedFormula->nrVariables = variables.size();
+                cachedFormula->fingerprint = Parser::formulaFingerprint(clauses, variables.size(), cachedFormula->rootLiterals, cachedFormula->substitutions, cachedFormula->originalIds);
+
+                workspace.assignLoaded(cachedFormula, formulaHash);
+                Parser::buildImplicationLists(variables, setup.initThreads);
+                formula = cachedFormula;
+                preparedFormula = true;
+            }
         }
+    }
 
-        outputFileStream << compressedOutput;
+    if (formula == nullptr) {
+        //the formula is prepared with the modes of the flags, the fingerprint identifies the prepared formula
+        formula = parsedFormulas.get(formulaFile, setup.parserThreads, flags);
+        preparedFormula = workspace.find(formula) != nullptr;
+        std::cout << (preparedFormula ? "Reused the clauses of the last model" : "Reading clauses") << std::endl;
+
+        if (setup.preprocess) {
+            const Preprocessing::Statistics& statistics = formula->preprocessing;
+            std::cout << "Removed " << statistics.duplicateLiterals << " duplicate literals, " << statistics.tautologies << " tautologies and "
+                      << statistics.duplicateClauses << " duplicate clauses" << std::endl;
+        }
     }
-    
-    outputFileStream.close();
 
-    delete heuristic;
+    if (setup.rootPropagation) {
+        std::cout << "Variables assigned before the first decision: " << formula->rootLiterals.size() << std::endl;
+    }
+    if (setup.substituteEquivalences) {
+        std::cout << "Variables substituted by equivalent literals: " << formula->substitutions.size() << std::endl;
+    }
+
+    return formula;
+}
+
+//copies the clauses of the formula into the workspace and builds the occurence and implication lists, the formula is stored in the formula cache if it is used
+void prepareWorkspace(const std::shared_ptr<const ParsedFormula>& formula, uint64_t formulaHash, const CompressionSetup& setup, Workspace& workspace) {
+    workspace.assign(formula, formulaHash, setup.initThreads);
+
+    //store the formula before the variables are corrected, as the correction depends on the model
+    if (!setup.formulaCache.empty()) {
+        workspace.initialScores = InitialScores::compute(workspace.variables, workspace.clauses, setup.initThreads);
+
+        FormulaCache cache(setup.formulaCache);
+        cache.store(formulaHash, workspace.clauses, workspace.variables, workspace.initialScores, formula->rootLiterals, formula->substitutions, formula->originalIds);
+    }
+
+    //binary clauses are propagated through the implication lists
+    Parser::buildImplicationLists(workspace.variables, setup.initThreads);
+}
+
+//assigns the variables of the root propagation and the substituted variables. They are the same for every model, only the checks of the model and
+//the values that are moved to the literals of the substitutions depend on it
+void assignInitialValues(const ParsedFormula& formula, Model& model, std::vector<Assignment>& values) {
+    //start from the assignments of the root propagation, their clauses are already removed from the formula
+    for (Lit lit: formula.rootLiterals) {
+        values[lit.id - 1] = lit.negative ? Assignment::FALSE : Assignment::TRUE;
+
+        if (model.contains(lit.id) && model.get(lit.id) != values[lit.id - 1]) {
+            throw std::runtime_error("Error, the model is not satisfying!");
+        }
+    }
+
+    //the substituted variables do not occur in the clauses, they are marked as assigned so that they are never decided.
+    //Their values are restored from their literals, so a model value of a substituted variable is moved to its literal
+    for (const Equivalences::Substitution& substitution: formula.substitutions) {
+        values[substitution.variable - 1] = Assignment::TRUE;
+
+        if (!model.contains(substitution.variable)) {
+            continue;
+        }
+
+        Lit lit = substitution.literal;
+        bool literalValue = (model.get(substitution.variable) == Assignment::TRUE) != lit.negative;
+
+        if (!model.contains(lit.id)) {
+            model.assign(ModelVar(literalValue ? static_cast<int>(lit.id) : -static_cast<int>(lit.id)));
+        } else if ((model.get(lit.id) == Assignment::TRUE) != literalValue) {
+            throw std::runtime_error("Error, the model is not satisfying!");
+        }
+    }
+}
+
+//corrects the length of the variables vector if the model is bigger than the size of the variable vector
+void correctVariables(std::vector<Var>& variables, const Model& model) {
+    if (model.size() > variables.size()) {
+        int diff = model.size() - variables.size();
+        for (int i = 1; i <= diff; i++) {
+            variables.push_back(Var(variables.size() + i));
+        }
+        std::cout << "Corrected number of variables: " << variables.size() << std::endl;
+    }
+}
+
+//searches the model with the heuristic in the clauses of the workspace, the values of the workspace contain the assignments before the first decision.
+//The components are built from the variables of the formula, the decompression does not know about the correction
+template<class HeuristicType>
+std::string searchModel(Workspace& workspace, unsigned int nrFormulaVariables, const Model& model, const CompressionSetup& setup, const InitialScores* scores, SearchInfo& info) {
+    if (setup.components) {
+        return compressComponents<HeuristicType>(workspace.clauses, nrFormulaVariables, model, workspace.values, setup, info);
+    }
+
+    return compressAssignment<HeuristicType>(workspace.clauses, workspace.variables, model, workspace.values, setup, scores, workspace.search, info);
+}
+
+//the values the decompression reconstructs after the search, it resets the don't care variables and assigns the rest of the variables of the model
+void replayValues(const std::vector<Assignment>& values, const std::vector<unsigned int>& dontCareVars, const Model& model, std::vector<Assignment>& replayedValues) {
+    replayedValues = values;
+
+    for (unsigned int id: dontCareVars) {
+        replayedValues[id - 1] = Assignment::OPEN;
+    }
+
+    for (unsigned int id = 1; id <= replayedValues.size(); id++) {
+        if (replayedValues[id - 1] == Assignment::OPEN && model.contains(id)) {
+            replayedValues[id - 1] = model.get(id);
+        }
+    }
+}
+
+//writes the header, the hashes of the reference and the priors and the heuristic of the portfolio in front of the encoding
+std::string serializeCompressedModel(uint64_t formulaFingerprint, const CompressionSetup& setup, const std::string& encoding) {
+    CompressionHeader header(formulaFingerprint, compressionFlags(setup));
+    std::string compressedModel = header.serialize();
+
+    if (header.hasFlag(CompressionHeader::REFERENCE)) {
+        compressedModel.append(ReferenceModel::serializeHash(setup.reference != nullptr ? setup.reference->hash : 0));
+    }
+    if (header.hasFlag(CompressionHeader::PRIORS)) {
+        compressedModel.append(PolarityPriors::serializeHash(setup.priors != nullptr ? setup.priors->hash : 0));
+    }
+    if (header.hasFlag(CompressionHeader::HEURISTIC)) {
+        compressedModel.append(Portfolio::serializeHeuristic(setup.heuristic));
+    }
+
+    compressedModel.append(encoding);
+
+    return compressedModel;
+}
+
+//compresses a single model into the given string. If the model content is given, the model was already read into memory and the model file is only used as its name.
+//The heuristic is a template parameter, so the whole compression loop is instantiated for every heuristic. The workspace is shared by the models of a batch.
+//If the replayed values are given, they are set to the values the decompression reconstructs, so the model can be used as a reference
+template<class HeuristicType>
+CompressionInfo compressModel(const char* formulaFile, const char* modelFile, std::string& compressedModel, CompressionSetup setup, ParsedFormulaCache& parsedFormulas, Workspace& workspace,
+                              const std::string* modelContent, std::vector<Assignment>* replayedValues) {
+    //set start time
+    const auto startTime = std::chrono::high_resolution_clock::now();
+
+    Parser parser(formulaFile, modelFile);
+    parser.setModelContent(modelContent);
+
+    //the clauses and the occurence lists are kept in the workspace, they are reused if the model belongs to the same formula as the last model
+    std::vector<Cl>& clauses = workspace.clauses;
+    std::vector<Var>& variables = workspace.variables;
+    uint64_t formulaHash = 0;
+    bool preparedFormula = false;
+    std::shared_ptr<const ParsedFormula> formula = loadFormula(formulaFile, setup, parsedFormulas, workspace, formulaHash, preparedFormula);
+
+    const std::vector<unsigned int>& originalIds = formula->originalIds;
+    uint64_t formulaFingerprint = formula->fingerprint;
+
+    //the priors were trained with the original ids of the formula
+    std::vector<Assignment> priorValues;
+    if (setup.priors != nullptr) {
+        setup.priors->check(parsedFormulas.contentHash(formulaFile), formulaFile);
+        priorValues = setup.priors->prepare(originalIds);
+        setup.priorValues = &priorValues;
+    }
+
+    std::cout << "Reading model" << std::endl;
+    Model model = parser.readModel(formula->nrVariables);
+
+    //the model is read with the original ids, everything after this uses the new ids
+    if (!originalIds.empty()) {
+        model = Renumbering::renumber(model, originalIds);
+    }
+
+    //measure parsing time
+    const auto parsingTime = std::chrono::high_resolution_clock::now();
+
+    std::cout << "Number of Variables: " << formula->nrVariables << std::endl;
+    std::cout << "Number of Clauses: " << formula->clauses.size() << std::endl;
+    std::cout << "Size of model: " << model.size() << std::endl;
+
+    if (!preparedFormula) {
+        prepareWorkspace(formula, formulaHash, setup, workspace);
+    }
+
+    //the components are built from the variables of the formula, the decompression does not know about the correction
+    unsigned int nrFormulaVariables = variables.size();
+    correctVariables(variables, model);
+
+    //the precomputed heuristic values are only available if the formula cache is used
+    const InitialScores* scores = setup.formulaCache.empty() ? nullptr : &workspace.initialScores;
+
+    std::vector<Assignment>& values = workspace.values;
+    values.assign(variables.size(), Assignment::OPEN);
+    assignInitialValues(*formula, model, values);
+
+    SearchInfo searchInfo;
+    std::string encoding = searchModel<HeuristicType>(workspace, nrFormulaVariables, model, setup, scores, searchInfo);
+
+    if (replayedValues != nullptr) {
+        if (setup.components) {
+            throw std::runtime_error("A reference model can not be combined with the components.");
+        }
+
+        replayValues(values, workspace.search.dontCareVars, model, *replayedValues);
+    }
+
+    //write the header that identifies the formula
+    compressedModel = serializeCompressedModel(formulaFingerprint, setup, encoding);
 
     //get overall execution time
     const auto overallTime = std::chrono::high_resolution_clock::now();
@@ -271,17 +603,342 @@ CompressionInfo compressModel(const char* formulaFile, const char* modelFile, co
     std::chrono::duration<double, std::milli> overallDuration = overallTime - startTime;
 
     //get the file sizes
-    std::uintmax_t modelFileSize = fs::file_size(modelFile);
-    std::uintmax_t compressionFileSize = fs::file_size(outputFile);
+    std::uintmax_t modelFileSize = modelContent != nullptr ? modelContent->size() : fs::file_size(modelFile);
+    std::uintmax_t compressionFileSize = compressedModel.size();
 
     //calculate hite rate
-    float predictionHitRate = (float) predictionMisses / nrPredictions;
+    float predictionHitRate = (float) searchInfo.predictionMisses / searchInfo.nrPredictions;
     predictionHitRate = 1.0 - predictionHitRate;
 
-    CompressionInfo info(clauses.size(), model.size(), variables.size(), modelFileSize, compressionFileSize, bitvector.size(), outputEncoding.size(), propagatedDontCareVars, predictionHitRate, parsingDuration.count(), overallDuration.count());
+    CompressionInfo info(clauses.size(), model.size(), variables.size(), modelFileSize, compressionFileSize, searchInfo.bitvectorSize, searchInfo.encodingSize, searchInfo.propagatedDontCareVars, predictionHitRate, parsingDuration.count(), overallDuration.count());
     return info;
 }
 
+typedef std::string (*SearchFunction)(Workspace&, unsigned int, const Model&, const CompressionSetup&, const InitialScores*, SearchInfo&);
+
+//selects the search of a heuristic of the portfolio
+SearchFunction selectSearch(const std::string& heuristic) {
+    if (heuristic == "none") {
+        return searchModel<ParsingOrder>;
+    } else if (heuristic == "jewa") {
+        return searchModel<JeroslowWang<false>>;
+    } else if (heuristic == "jewa_dyn") {
+        return searchModel<JeroslowWang<true>>;
+    } else if (heuristic == "moms") {
+        return searchModel<MomsFreeman<false>>;
+    } else if (heuristic == "moms_dyn") {
+        return searchModel<MomsFreeman<true>>;
+    } else if (heuristic == "hybr") {
+        return searchModel<HybridHeuristic<false>>;
+    } else if (heuristic == "hybr_dyn") {
+        return searchModel<HybridHeuristic<true>>;
+    }
+
+    throw std::runtime_error("Unknown heuristic: " + heuristic);
+}
+
+//compresses the model with every heuristic of the portfolio and keeps the smallest result, the first heuristic of the portfolio wins a tie.
+//The formula, the model and the assignments before the first decision are prepared once. Every heuristic searches in its own copy of the
+//clauses on its own thread and only reads the shared formula, the model and the initial scores, so the wall time is bounded by the slowest heuristic
+CompressionInfo compressPortfolio(const char* formulaFile, const char* modelFile, std::string& compressedModel, CompressionSetup setup, ParsedFormulaCache& parsedFormulas, Workspace& workspace,
+                                  const std::string* modelContent, std::vector<Assignment>* replayedValues) {
+    const auto startTime = std::chrono::high_resolution_clock::now();
+
+    Parser parser(formulaFile, modelFile);
+    parser.setModelContent(modelContent);
+
+    uint64_t formulaHash = 0;
+    bool preparedFormula = false;
+    std::shared_ptr<const ParsedFormula> formula = loadFormula(formulaFile, setup, parsedFormulas, workspace, formulaHash, preparedFormula);
+
+    std::vector<Assignment> priorValues;
+    if (setup.priors != nullptr) {
+        setup.priors->check(parsedFormulas.contentHash(formulaFile), formulaFile);
+        priorValues = setup.priors->prepare(formula->originalIds);
+        setup.priorValues = &priorValues;
+    }
+
+    std::cout << "Reading model" << std::endl;
+    Model model = parser.readModel(formula->nrVariables);
+
+    if (!formula->originalIds.empty()) {
+        model = Renumbering::renumber(model, formula->originalIds);
+    }
+
+    const auto parsingTime = std::chrono::high_resolution_clock::now();
+
+    //the workspace of the batch is used by the first heuristic
+    if (!preparedFormula) {
+        prepareWorkspace(formula, formulaHash, setup, workspace);
+    }
+
+    unsigned int nrFormulaVariables = workspace.variables.size();
+    correctVariables(workspace.variables, model);
+
+    std::vector<Assignment> initialValues(workspace.variables.size(), Assignment::OPEN);
+    assignInitialValues(*formula, model, initialValues);
+
+    const InitialScores* scores = setup.formulaCache.empty() ? nullptr : &workspace.initialScores;
+    const std::vector<std::string>& heuristics = setup.portfolio;
+    std::vector<std::string> encodings(heuristics.size());
+    std::vector<SearchInfo> infos(heuristics.size());
+    std::vector<std::vector<Assignment>> candidateValues(heuristics.size());
+
+    if (workspace.portfolio.size() < heuristics.size() - 1) {
+        workspace.portfolio.resize(heuristics.size() - 1);
+    }
+
+    unsigned int nrThreads = setup.portfolioThreads == 0 ? heuristics.size() : setup.portfolioThreads;
+
+    Parallel::forEach(heuristics.size(), nrThreads, [&](std::size_t i) {
+        Workspace& candidate = i == 0 ? workspace : workspace.portfolio[i - 1];
+
+        if (i != 0) {
+            if (candidate.find(formula) == nullptr) {
+                candidate.assign(formula, formulaHash, setup.initThreads);
+                Parser::buildImplicationLists(candidate.variables, setup.initThreads);
+            }
+
+            correctVariables(candidate.variables, model);
+        }
+
+        candidate.values = initialValues;
+
+        CompressionSetup candidateSetup = setup;
+        candidateSetup.heuristic = heuristics[i];
+        encodings[i] = selectSearch(heuristics[i])(candidate, nrFormulaVariables, model, candidateSetup, scores, infos[i]);
+
+        if (replayedValues != nullptr) {
+            replayValues(candidate.values, candidate.search.dontCareVars, model, candidateValues[i]);
+        }
+    });
+
+    std::size_t best = 0;
+    std::cout << "Heuristic portfolio:";
+    for (std::size_t i = 0; i < heuristics.size(); i++) {
+        std::cout << " " << heuristics[i] << "=" << encodings[i].size();
+
+        if (encodings[i].size() < encodings[best].size()) {
+            best = i;
+        }
+    }
+    std::cout << ", chose " << heuristics[best] << std::endl;
+
+    setup.heuristic = heuristics[best];
+    compressedModel = serializeCompressedModel(formula->fingerprint, setup, encodings[best]);
+
+    if (replayedValues != nullptr) {
+        *replayedValues = std::move(candidateValues[best]);
+    }
+
+    const auto overallTime = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> parsingDuration = parsingTime - startTime;
+    std::chrono::duration<double, std::milli> overallDuration = overallTime - startTime;
+
+    std::uintmax_t modelFileSize = modelContent != nullptr ? modelContent->size() : fs::file_size(modelFile);
+    const SearchInfo& searchInfo = infos[best];
+    float predictionHitRate = 1.0 - (float) searchInfo.predictionMisses / searchInfo.nrPredictions;
+
+    return CompressionInfo(workspace.clauses.size(), model.size(), workspace.variables.size(), modelFileSize, compressedModel.size(), searchInfo.bitvectorSize, searchInfo.encodingSize,
+                           searchInfo.propagatedDontCareVars, predictionHitRate, parsingDuration.count(), overallDuration.count());
+}
+
+//a model of a batch that is compressed together with other models of the same formula
+struct BatchModel {
+    std::string name;
+    std::string file;
+    //the content of a model that was read from an archive, the file is only used as its name
+    std::string content;
+    bool inMemory = false;
+    std::string compressedModel;
+};
+
+//compresses up to 64 models of the same formula with the bit-sliced search, only for the heuristics with a static order and static predictions.
+//The formula is prepared once and every model is a lane of the search. The models that fail the checks of the root propagation or the
+//substitutions, need more variables than the formula or do not finish in their lane are compressed alone, so the result is the same as with compressModel.
+//Returns the statistics in the order of the models, the durations of the shared work are split evenly between the models
+template<class HeuristicType>
+std::vector<CompressionInfo> compressGroup(const char* formulaFile, std::vector<BatchModel>& group, const CompressionSetup& setup, ParsedFormulaCache& parsedFormulas, Workspace& workspace) {
+    const auto startTime = std::chrono::high_resolution_clock::now();
+
+    std::vector<Cl>& clauses = workspace.clauses;
+    std::vector<Var>& variables = workspace.variables;
+    uint64_t formulaHash = 0;
+    bool preparedFormula = false;
+    std::shared_ptr<const ParsedFormula> formula = loadFormula(formulaFile, setup, parsedFormulas, workspace, formulaHash, preparedFormula);
+
+    std::vector<Assignment> priorValues;
+    if (setup.priors != nullptr) {
+        setup.priors->check(parsedFormulas.contentHash(formulaFile), formulaFile);
+        priorValues = setup.priors->prepare(formula->originalIds);
+    }
+
+    std::vector<Model> models;
+    models.reserve(group.size());
+
+    for (BatchModel& batchModel: group) {
+        Parser parser(formulaFile, batchModel.file.c_str());
+        parser.setModelContent(batchModel.inMemory ? &batchModel.content : nullptr);
+        models.push_back(parser.readModel(formula->nrVariables));
+
+        if (!formula->originalIds.empty()) {
+            models.back() = Renumbering::renumber(models.back(), formula->originalIds);
+        }
+    }
+
+    if (!preparedFormula) {
+        prepareWorkspace(formula, formulaHash, setup, workspace);
+    }
+
+    const auto parsingTime = std::chrono::high_resolution_clock::now();
+
+    //the assignments before the first decision are the same for every model
+    std::vector<Assignment> initialValues(variables.size(), Assignment::OPEN);
+    std::vector<std::size_t> laneModels;
+    std::vector<Model> lanes;
+    std::vector<std::size_t> singleModels;
+
+    for (std::size_t i = 0; i < models.size(); i++) {
+        if (models[i].size() > variables.size()) {
+            singleModels.push_back(i);
+            continue;
+        }
+
+        try {
+            assignInitialValues(*formula, models[i], initialValues);
+        } catch (const std::runtime_error&) {
+            singleModels.push_back(i);
+            continue;
+        }
+
+        laneModels.push_back(i);
+        lanes.push_back(std::move(models[i]));
+    }
+
+    //the order and the predictions of the static heuristics do not depend on the model
+    const InitialScores* scores = setup.formulaCache.empty() ? nullptr : &workspace.initialScores;
+    HeuristicType* heuristic = HeuristicType::create(variables, clauses, setup, scores);
+
+    if (setup.reference != nullptr) {
+        heuristic->setReference(&setup.reference->values);
+    }
+    if (setup.priors != nullptr) {
+        heuristic->setPriors(&priorValues);
+    }
+
+    std::vector<unsigned int> order;
+    order.reserve(variables.size());
+    while (heuristic->hasNextVar()) {
+        order.push_back(heuristic->getNextVar().id);
+    }
+
+    std::vector<Assignment> predictions;
+    predictions.reserve(variables.size());
+    for (const Var& var: variables) {
+        predictions.push_back(heuristic->getPredictedAssignment(var));
+    }
+
+    delete heuristic;
+
+    std::vector<BitSliced::Lane> results(lanes.size());
+    if (!lanes.empty()) {
+        BitSliced::Search search(clauses, variables, results);
+        search.run(order, predictions, lanes, initialValues, setup.predictionFlip, setup.disableFaithfulMode);
+    }
+
+    const auto searchTime = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> parsingDuration = (parsingTime - startTime) / group.size();
+    std::chrono::duration<double, std::milli> overallDuration = (searchTime - startTime) / group.size();
+
+    std::vector<std::optional<CompressionInfo>> infos(group.size());
+    std::size_t nrBitSliced = 0;
+
+    for (std::size_t i = 0; i < lanes.size(); i++) {
+        BatchModel& batchModel = group[laneModels[i]];
+        BitSliced::Lane& lane = results[i];
+
+        if (lane.failed) {
+            singleModels.push_back(laneModels[i]);
+            continue;
+        }
+
+        std::string encoding = encodeDecisions(lane.bitvector, lane.dontCareVars, setup, workspace.search.outputEncoding);
+        batchModel.compressedModel = serializeCompressedModel(formula->fingerprint, setup, encoding);
+
+        std::uintmax_t modelFileSize = batchModel.inMemory ? batchModel.content.size() : fs::file_size(batchModel.file);
+        float predictionHitRate = 1.0 - (float) lane.predictionMisses / lane.nrPredictions;
+
+        infos[laneModels[i]].emplace(clauses.size(), lanes[i].size(), variables.size(), modelFileSize, batchModel.compressedModel.size(), lane.bitvector.size(),
+                                     workspace.search.outputEncoding.size(), lane.propagatedDontCareVars, predictionHitRate, parsingDuration.count(), overallDuration.count());
+        nrBitSliced += 1;
+    }
+
+    std::cout << "Compressed " << nrBitSliced << " of " << group.size() << " models in the bit-sliced search" << std::endl;
+
+    for (std::size_t index: singleModels) {
+        BatchModel& batchModel = group[index];
+        infos[index].emplace(compressModel<HeuristicType>(formulaFile, batchModel.file.c_str(), batchModel.compressedModel, setup, parsedFormulas, workspace,
+                                                          batchModel.inMemory ? &batchModel.content : nullptr, nullptr));
+    }
+
+    std::vector<CompressionInfo> groupInfos;
+    groupInfos.reserve(group.size());
+    for (std::optional<CompressionInfo>& info: infos) {
+        groupInfos.push_back(std::move(*info));
+    }
+
+    return groupInfos;
+}
+
+typedef CompressionInfo (*CompressionFunction)(const char*, const char*, std::string&, CompressionSetup, ParsedFormulaCache&, Workspace&, const std::string*, std::vector<Assignment>*);
+typedef std::vector<CompressionInfo> (*GroupCompressionFunction)(const char*, std::vector<BatchModel>&, const CompressionSetup&, ParsedFormulaCache&, Workspace&);
+
+//selects the compression for the heuristic once, the returned function contains the compression loop for this heuristic
+CompressionFunction selectCompression(const CompressionSetup& setup) {
+    if (setup.heuristic == "auto") {
+        return compressPortfolio;
+    } else if (setup.heuristic == "none") {
+        return compressModel<ParsingOrder>;
+    } else if (setup.heuristic == "jewa") {
+        return compressModel<JeroslowWang<false>>;
+    } else if (setup.heuristic == "jewa_dyn") {
+        return compressModel<JeroslowWang<true>>;
+    } else if (setup.heuristic == "moms") {
+        return compressModel<MomsFreeman<false>>;
+    } else if (setup.heuristic == "moms_dyn") {
+        return compressModel<MomsFreeman<true>>;
+    } else if (setup.heuristic == "hybr") {
+        return compressModel<HybridHeuristic<false>>;
+    } else if (setup.heuristic == "hybr_dyn") {
+        return compressModel<HybridHeuristic<true>>;
+    }
+
+    throw std::runtime_error("Unknown heuristic: " + setup.heuristic);
+}
+
+//selects the bit-sliced compression of a batch. The predictions of the parsing order change with the satisfied clauses of every model,
+//so only the heuristics whose order and predictions are fixed before the first decision are supported
+GroupCompressionFunction selectGroupCompression(const CompressionSetup& setup) {
+    if (setup.components) {
+        throw std::runtime_error("The bit-sliced search can not be combined with the components.");
+    }
+
+    if (setup.heuristic == "jewa") {
+        return compressGroup<JeroslowWang<false>>;
+    } else if (setup.heuristic == "moms") {
+        return compressGroup<MomsFreeman<false>>;
+    } else if (setup.heuristic == "hybr") {
+        return compressGroup<HybridHeuristic<false>>;
+    }
+
+    throw std::runtime_error("The bit-sliced search only supports the static heuristics jewa, moms and hybr.");
+}
+
+void writeCompressedModel(const std::string& outputFile, const std::string& compressedModel) {
+    std::ofstream outputFileStream(outputFile, std::ios::binary);
+    outputFileStream.write(compressedModel.data(), compressedModel.size());
+    outputFileStream.close();
+}
 
 int main(int argc, char** argv) {
     if (argc < 4) {
@@ -314,9 +971,54 @@ int main(int argc, char** argv) {
                 setup.predictionFlip = std::stoi(argv[i + 1]);
             } else if (argString == "-hp") {
                 setup.hybridHeuristicParam = std::stoi(argv[i + 1]);
+            } else if (argString == "-pt") {
+                setup.parserThreads = std::stoi(argv[i + 1]);
+            } else if (argString == "-it") {
+                setup.initThreads = std::stoi(argv[i + 1]);
+            } else if (argString == "--formula-cache") {
+                setup.formulaCache = std::string(argv[i + 1]);
+            } else if (argString == "--scores") {
+                std::string scores(argv[i + 1]);
+                if (scores != "float" && scores != "fixed") {
+                    throw std::runtime_error("Unknown scores: " + scores);
+                }
+                setup.fixedPointScores = scores == "fixed";
+            } else if (argString == "--preprocess") {
+                setup.preprocess = true;
+                increase = 1;
+            } else if (argString == "--root-propagation") {
+                setup.rootPropagation = true;
+                increase = 1;
+            } else if (argString == "--equivalent-literals") {
+                setup.substituteEquivalences = true;
+                increase = 1;
+            } else if (argString == "--components") {
+                setup.components = true;
+                increase = 1;
+            } else if (argString == "--renumber") {
+                setup.renumber = true;
+                increase = 1;
+            } else if (argString == "--reference") {
+                setup.referenceModel = std::string(argv[i + 1]);
+            } else if (argString == "--priors") {
+                setup.priorsPath = std::string(argv[i + 1]);
+            } else if (argString == "--portfolio") {
+                setup.portfolio = Portfolio::parseHeuristics(argv[i + 1]);
+            } else if (argString == "-ht") {
+                setup.portfolioThreads = std::stoi(argv[i + 1]);
+            } else if (argString == "-cdt") {
+                setup.codecThreads = std::stoi(argv[i + 1]);
+            } else if (argString == "--bit-sliced") {
+                setup.bitSliced = true;
+                increase = 1;
+            } else if (argString == "-ct") {
+                setup.componentThreads = std::stoi(argv[i + 1]);
             } else if (argString == "-f") {
                 setup.disableFaithfulMode = true;
                 increase = 1;
+            } else if (argString == "--container") {
+                setup.container = true;
+                increase = 1;
             } else {
                 throw std::runtime_error("Unknown argment: " + argString);
             }
@@ -325,13 +1027,56 @@ int main(int argc, char** argv) {
         }
     }
 
+    //the portfolio contains all heuristics if it is not given
+    if (setup.heuristic == "auto" && setup.portfolio.empty()) {
+        setup.portfolio = Portfolio::HEURISTICS;
+    } else if (setup.heuristic != "auto" && !setup.portfolio.empty()) {
+        throw std::runtime_error("The portfolio can only be given together with the heuristic auto.");
+    }
+
     std::vector<CompressionInfo> compressionStats;
+    ParsedFormulaCache parsedFormulas;
+    Workspace workspace;
+    CompressionFunction compress = selectCompression(setup);
+    GroupCompressionFunction compressBatch = setup.bitSliced ? selectGroupCompression(setup) : nullptr;
+
+    if (!setup.referenceModel.empty() && setup.components) {
+        throw std::runtime_error("A reference model can not be combined with the components.");
+    }
+    if (!setup.priorsPath.empty() && setup.components) {
+        throw std::runtime_error("Polarity priors can not be combined with the components.");
+    }
+
+    //the models can be read directly from an archive if the output is a directory
+    bool modelArchive = fs::is_directory(outputPath) && fs::is_regular_file(modelPath) && ArchiveReader::isArchive(argv[2]);
+    bool formulaArchive = fs::is_directory(outputPath) && fs::is_regular_file(formulaPath) && ArchiveReader::isArchive(argv[1]);
 
     //input is files so only one compression has to be done
-    if (fs::is_regular_file(formulaPath) && fs::is_regular_file(modelPath)) {
+    if (!modelArchive && !formulaArchive && fs::is_regular_file(formulaPath) && fs::is_regular_file(modelPath)) {
         std::cout << "Compress model: " << modelPath << std::endl;
         
-        CompressionInfo info = compressModel(argv[1], argv[2], argv[3], setup);
+        if (setup.container) {
+            throw std::runtime_error("Containers can only be written in batch mode.");
+        }
+        if (setup.bitSliced) {
+            throw std::runtime_error("The bit-sliced search can only be used in batch mode.");
+        }
+
+        if (!setup.priorsPath.empty()) {
+            setup.priors = std::make_shared<const PolarityPriors>(PolarityPriors::read(setup.priorsPath));
+        }
+
+        //the reference is compressed like every other model, only the reference itself is not predicted from it
+        if (!setup.referenceModel.empty() && !fs::equivalent(setup.referenceModel, modelPath)) {
+            std::string compressedReference;
+            std::vector<Assignment> referenceValues;
+            compress(argv[1], setup.referenceModel.c_str(), compressedReference, setup, parsedFormulas, workspace, nullptr, &referenceValues);
+            setup.reference = std::make_shared<const ReferenceModel>(std::move(referenceValues), compressedReference);
+        }
+
+        std::string compressedModel;
+        CompressionInfo info = compress(argv[1], argv[2], compressedModel, setup, parsedFormulas, workspace, nullptr, nullptr);
+        writeCompressedModel(argv[3], compressedModel);
 
         compressionStats.push_back(info);
 
@@ -339,43 +1084,209 @@ int main(int argc, char** argv) {
         StatsOutput output(compressionStats);
         output.printStatistics();
         return 0;
-    } else if (fs::is_directory(formulaPath) && fs::is_directory(modelPath) && fs::is_directory(outputPath)) {
-        //iterate over the subdirectories in the models directory
-        fs::directory_iterator modelIterator(modelPath);
+    } else if ((fs::is_directory(formulaPath) || formulaArchive) && (fs::is_directory(modelPath) || modelArchive) && fs::is_directory(outputPath)) {
+        std::map<std::string, std::unique_ptr<ModelContainer::Writer>> containers;
+
+        //writes the compressed model to the output folder of the instance or appends it to the container of the instance
+        auto storeCompressedModel = [&](const std::string& instanceName, const std::string& modelName, const std::string& compressedModel) {
+            if (setup.container) {
+                std::unique_ptr<ModelContainer::Writer>& container = containers[instanceName];
+
+                if (container == nullptr) {
+                    fs::path containerFile = outputPath;
+                    containerFile.append(instanceName + ".pmc");
+                    container = std::make_unique<ModelContainer::Writer>(containerFile);
+                }
 
-        for (fs::directory_entry modelsEntry: modelIterator) {
-            if (modelsEntry.is_directory()) {
-                std::string instanceName = modelsEntry.path().filename();
+                container->add(modelName, compressedModel);
+            } else {
+                //create new output folder
+                fs::path outputFile = outputPath;
+                outputFile.append(instanceName);
+                fs::create_directory(outputFile);
+                outputFile.append(modelName);
+
+                writeCompressedModel(outputFile, compressedModel);
+            }
+        };
+
+        //compresses the models of the group with the bit-sliced search and stores them in their order
+        std::vector<BatchModel> group;
+        auto compressGroupModels = [&](const std::string& instanceFile, const std::string& instanceName) {
+            if (group.empty()) {
+                return;
+            }
+
+            std::vector<CompressionInfo> infos = compressBatch(instanceFile.c_str(), group, setup, parsedFormulas, workspace);
+
+            for (std::size_t i = 0; i < group.size(); i++) {
+                storeCompressedModel(instanceName, group[i].name, group[i].compressedModel);
+                infos[i].addNames(instanceName, group[i].name);
+                compressionStats.push_back(infos[i]);
+            }
+
+            group.clear();
+        };
+
+        //compresses the reference model of an instance, the following models of the instance are predicted from its values
+        auto compressReference = [&](const std::string& instanceFile, const std::string& instanceName, const std::string& modelFile, const std::string* modelContent) {
+            std::cout << "Compress reference model: " << modelFile << std::endl;
+
+            setup.reference = nullptr;
+            std::string compressedModel;
+            std::vector<Assignment> referenceValues;
+            CompressionInfo info = compress(instanceFile.c_str(), modelFile.c_str(), compressedModel, setup, parsedFormulas, workspace, modelContent, &referenceValues);
+            storeCompressedModel(instanceName, setup.referenceModel, compressedModel);
+            info.addNames(instanceName, setup.referenceModel);
+            compressionStats.push_back(info);
+
+            setup.reference = std::make_shared<const ReferenceModel>(std::move(referenceValues), compressedModel);
+        };
+
+        //loads the priors of an instance, an instance without a priors file is compressed without priors
+        auto loadPriors = [&](const std::string& instanceName) {
+            setup.priors = nullptr;
+
+            fs::path priorsFile = setup.priorsPath;
+            priorsFile.append(instanceName + ".priors");
+
+            if (!setup.priorsPath.empty() && fs::is_regular_file(priorsFile)) {
+                setup.priors = std::make_shared<const PolarityPriors>(PolarityPriors::read(priorsFile));
+            }
+        };
+
+        //the formulas of an archive are kept in memory under the path they would have if the archive was a directory
+        if (formulaArchive) {
+            ArchiveReader formulaReader(argv[1]);
+            std::string entryPath;
+            std::string content;
+
+            while (formulaReader.nextEntry(entryPath, content)) {
+                fs::path instancePath = formulaPath;
+                instancePath.append(fs::path(entryPath).filename().string());
+                parsedFormulas.addFile(instancePath, std::move(content));
+            }
+        }
+
+        //iterate over the models in the archive, the instance is given by the directory of the model
+        if (modelArchive) {
+            ArchiveReader modelReader(argv[2]);
+            std::string entryPath;
+            std::string modelContent;
+            //the group of the bit-sliced search contains consecutive models of the same instance. The reference of an instance
+            //is used for the models that follow it in the archive, the models in front of it are compressed without a reference
+            std::string groupInstanceFile;
+            std::string groupInstanceName;
+
+            while (modelReader.nextEntry(entryPath, modelContent)) {
+                fs::path entry(entryPath);
+                std::string instanceName = entry.parent_path().filename();
+                std::string modelName = entry.filename();
+
+                if (instanceName.empty()) {
+                    std::cout << "Skip model without instance directory: " << entryPath << std::endl;
+                    continue;
+                }
 
                 fs::path instancePath = formulaPath;
                 instancePath.append(instanceName);
                 instancePath.replace_extension(".cnf");
+                std::string instanceFileString(instancePath);
+
+                if (instanceName != groupInstanceName) {
+                    compressGroupModels(groupInstanceFile, groupInstanceName);
+                    groupInstanceFile = instanceFileString;
+                    groupInstanceName = instanceName;
+                    setup.reference = nullptr;
+                    loadPriors(instanceName);
+                }
 
-                //create new output folder
-                fs::path outputSubdirectory = outputPath;
-                outputSubdirectory.append(instanceName);
-                fs::create_directory(outputSubdirectory);
-
-                //iterate over all models in the folder and compress them
-                for(fs::directory_entry model: fs::directory_iterator{modelsEntry.path()}) {
-                    std::string instanceFileString(instancePath);
-                    std::string modelFileString(model.path());
-
-                    //get output file
-                    std::string modelName = model.path().filename();
-                    fs::path outputFile = outputSubdirectory;
-                    outputFile.append(modelName);
-                    std::string outputFileString(outputFile);
-
-                    std::cout << "Compress model: " << model.path() << std::endl;
-
-                    CompressionInfo info = compressModel(instanceFileString.c_str(), modelFileString.c_str(), outputFileString.c_str(), setup);
-                    info.addNames(instanceName, modelName);
-                    compressionStats.push_back(info);
+                if (!setup.referenceModel.empty() && modelName == setup.referenceModel) {
+                    compressGroupModels(groupInstanceFile, groupInstanceName);
+                    compressReference(instanceFileString, instanceName, entryPath, &modelContent);
+                    continue;
+                }
+
+                std::cout << "Compress model: " << entryPath << std::endl;
+
+                if (compressBatch != nullptr) {
+                    if (group.size() == BitSliced::LANES) {
+                        compressGroupModels(groupInstanceFile, groupInstanceName);
+                    }
+
+                    group.push_back(BatchModel{modelName, entryPath, std::move(modelContent), true, ""});
+                    continue;
+                }
+
+                std::string compressedModel;
+                CompressionInfo info = compress(instanceFileString.c_str(), entryPath.c_str(), compressedModel, setup, parsedFormulas, workspace, &modelContent, nullptr);
+                storeCompressedModel(instanceName, modelName, compressedModel);
+                info.addNames(instanceName, modelName);
+                compressionStats.push_back(info);
+            }
+
+            compressGroupModels(groupInstanceFile, groupInstanceName);
+        } else {
+            //iterate over the subdirectories in the models directory
+            fs::directory_iterator modelIterator(modelPath);
+
+            for (fs::directory_entry modelsEntry: modelIterator) {
+                if (modelsEntry.is_directory()) {
+                    std::string instanceName = modelsEntry.path().filename();
+
+                    fs::path instancePath = formulaPath;
+                    instancePath.append(instanceName);
+                    instancePath.replace_extension(".cnf");
+
+                    loadPriors(instanceName);
+
+                    //the reference of the instance is compressed first
+                    setup.reference = nullptr;
+                    fs::path referencePath = modelsEntry.path();
+                    referencePath.append(setup.referenceModel);
+
+                    if (!setup.referenceModel.empty() && fs::is_regular_file(referencePath)) {
+                        compressReference(instancePath, instanceName, referencePath, nullptr);
+                    }
+
+                    //iterate over all models in the folder and compress them
+                    for(fs::directory_entry model: fs::directory_iterator{modelsEntry.path()}) {
+                        std::string instanceFileString(instancePath);
+                        std::string modelFileString(model.path());
+                        std::string modelName = model.path().filename();
+
+                        if (setup.reference != nullptr && modelName == setup.referenceModel) {
+                            continue;
+                        }
+
+                        std::cout << "Compress model: " << model.path() << std::endl;
+
+                        if (compressBatch != nullptr) {
+                            group.push_back(BatchModel{modelName, modelFileString, "", false, ""});
+
+                            if (group.size() == BitSliced::LANES) {
+                                compressGroupModels(instanceFileString, instanceName);
+                            }
+                            continue;
+                        }
+
+                        std::string compressedModel;
+                        CompressionInfo info = compress(instanceFileString.c_str(), modelFileString.c_str(), compressedModel, setup, parsedFormulas, workspace, nullptr, nullptr);
+                        storeCompressedModel(instanceName, modelName, compressedModel);
+                        info.addNames(instanceName, modelName);
+                        compressionStats.push_back(info);
+                    }
+
+                    compressGroupModels(instancePath, instanceName);
                 }
             }
         }
 
+        //write the indices of the containers
+        for (auto& [instanceName, container]: containers) {
+            container->close();
+        }
+
         //print the statistics
         StatsOutput output(compressionStats);
         output.printStatistics();
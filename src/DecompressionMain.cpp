@@ -2,15 +2,31 @@
 #include <deque>
 #include <fstream>
 #include <filesystem>
+#include <numeric>
+#include <algorithm>
 
 #include "Parser.h"
 #include "Propagation.h"
 #include "SATTypes.h"
 #include "Heuristics.h"
+#include "FormulaCache.h"
+#include "ParsedFormulaCache.h"
+#include "CompressionHeader.h"
+#include "Equivalences.h"
+#include "Components.h"
+#include "Renumbering.h"
+#include "Workspace.h"
+#include "Parallel.h"
+#include "ModelContainer.h"
+#include "ReferenceModel.h"
+#include "PolarityPriors.h"
+#include "Portfolio.h"
 
 namespace fs = std::filesystem;
 
-std::map<unsigned int, double> Heuristic::heuristicValues;
+thread_local std::map<unsigned int, double> Heuristic::heuristicValues;
+thread_local std::map<unsigned int, FixedPoint::Score> Heuristic::fixedPointValues;
+thread_local bool Heuristic::compareFixedPoint = false;
 
 struct DecompressionSetup
 {
@@ -20,8 +36,24 @@ struct DecompressionSetup
     unsigned int golombRiceParameter;
     unsigned int predictionFlip;
     unsigned int hybridHeuristicParam;
-
-    explicit DecompressionSetup() : heuristic("jewa_dyn"), genericCompression("golrice"), momsParameter(10.0), golombRiceParameter(2), predictionFlip(5) {}
+    unsigned int parserThreads;
+    unsigned int initThreads;
+    std::string formulaCache;
+    //read from the header of every compressed model, the heuristic values must have the same number format as in the compression
+    bool fixedPointScores;
+    std::string containerModel;
+    unsigned int componentThreads;
+    //name of the reference model of every instance, or the compressed reference file if a single model is decompressed
+    std::string referenceModel;
+    //the reference of the instance of the current model
+    std::shared_ptr<const ReferenceModel> reference;
+    //directory of the polarity priors of the instances, or the priors file if a single model is decompressed
+    std::string priorsPath;
+    //the priors of the instance of the current model and their values with the ids of the prepared formula
+    std::shared_ptr<const PolarityPriors> priors;
+    const std::vector<Assignment>* priorValues;
+
+    explicit DecompressionSetup() : heuristic("jewa_dyn"), genericCompression("golrice"), momsParameter(10.0), golombRiceParameter(2), predictionFlip(5), hybridHeuristicParam(100), parserThreads(1), initThreads(1), formulaCache(""), fixedPointScores(false), containerModel(""), componentThreads(1), referenceModel(""), priorsPath(""), priorValues(nullptr) {}
 };
 
 
@@ -45,65 +77,19 @@ struct DecompressionInfo {
 
 };
 
-DecompressionInfo decompressModel(const char* formulaFile, const char* modelFile, const char* outputFile, DecompressionSetup setup) {
-    //set start time
-    const auto startTime = std::chrono::high_resolution_clock::now();
-
-    Parser parser(formulaFile, modelFile);
-
-    std::vector<Cl> clauses = parser.readClauses();
-    std::vector<Var> variables = parser.readVariables();
-    std::deque<uint64_t> compresssionDistances = parser.readCompressedFile(setup.genericCompression, setup.golombRiceParameter, variables.size());
-
-    std::cout << "Number of Variables: " << variables.size() << std::endl;
-    std::cout << "Number of Clauses: " << clauses.size() << std::endl;
-    std::cout << "Number of distances: " << compresssionDistances.size() << std::endl;
-
-    std::cout << "Diff encoding: ";
-    for (uint32_t i: compresssionDistances) {
-    	std::cout << i << ", ";
-    }
-    std::cout << std::endl;
-
-     //measure parsing time
-    const auto parsingTime = std::chrono::high_resolution_clock::now();
-
-    //build occurence list
-    for (Cl& clause: clauses) {
-        for (Lit lit: clause.literals) {
-            Var& var = variables.at(lit.id - 1);
-
-            if (lit.negative) {
-                var.addNegClause(&clause);
-            } else {
-                var.addPosClause(&clause);
-            }
-        }
-    }
-
-    Heuristic* heuristic;
-
+//replays the decisions of the compression with the heuristic and assigns the variables of the model.
+//The occurence and implication lists must be built and the values contain the assignments before the first decision
+template<class HeuristicType>
+void replayAssignment(std::vector<Cl>& clauses, std::vector<Var>& variables, std::deque<uint64_t>& compresssionDistances, std::vector<Assignment>& values,
+                      const DecompressionSetup& setup, const InitialScores* scores, SearchBuffers& buffers) {
     //create Heuristic object to sort the variables using a specific heuristic
-    if (setup.heuristic == "none") {
-        heuristic = new ParsingOrder(variables);
-    } else if (setup.heuristic == "jewa") {
-        heuristic = new JeroslowWang(variables, false);
-    } else if (setup.heuristic == "jewa_dyn") {
-        heuristic = new JeroslowWang(variables, true);
-    } else if (setup.heuristic == "moms") {
-        heuristic = new MomsFreeman(variables, clauses, false, setup.momsParameter);
-    } else if (setup.heuristic == "moms_dyn") {
-        heuristic = new MomsFreeman(variables, clauses, true, setup.momsParameter);
-    } else if (setup.heuristic == "hybr") {
-        heuristic = new HybridHeuristic(variables, false, setup.hybridHeuristicParam);
-    } else if (setup.heuristic == "hybr_dyn") {
-        heuristic = new HybridHeuristic(variables, true, setup.hybridHeuristicParam);
-    } else {
-        throw std::runtime_error("Unknown heuristic: " + setup.heuristic);
+    HeuristicType* heuristic = HeuristicType::create(variables, clauses, setup, scores);
+
+    if (setup.reference != nullptr) {
+        heuristic->setReference(&setup.reference->values);
     }
+    heuristic->setPriors(setup.priorValues);
 
-    //Heuristic* heuristic = new MomsFreeman(variables, clauses, true);
-    //Heuristic* heuristic = new JeroslowWang(variables, true);
     bool allSatisfied = false;
     bool allDistancesUsed = false;
     uint64_t currentDistance;
@@ -119,20 +105,18 @@ DecompressionInfo decompressModel(const char* formulaFile, const char* modelFile
         
     }
 
-    std::vector<Assignment> values(variables.size(), Assignment::OPEN);
-    std::vector<unsigned int> trail;
+    buffers.clear();
+    std::vector<unsigned int>& trail = buffers.trail;
     int head = 0;
+    std::size_t firstOpenClause = 0;
 
     while (!allSatisfied) {
         //get next value from the model and assign it to the variable
         Var nextVar = heuristic->getNextVar();
 
-        //get next value if the variable is already assigned
+        //get next value if the variable is already assigned, the compression does not write bits for these variables
         while (values[nextVar.id -1] != Assignment::OPEN) {
             nextVar = heuristic->getNextVar();
-            if (!allDistancesUsed) {
-                currentDistance -= 1;
-            }
         }
 
         //reset the number of misses if the current distance is over 1
@@ -201,14 +185,12 @@ DecompressionInfo decompressModel(const char* formulaFile, const char* modelFile
         //std::cout << "Number of assigned Variables: " << nrAssigned << std::endl;
 
         //check if all clauses are already satisfied
-        allSatisfied = true;
-
-        for (Cl clause: clauses) {
-            if (clause.literals.size() != 0) {
-                allSatisfied = false;
-                break;
-            }   
+        //the clauses are only cleared during the search, so the check continues at the first clause that was not satisfied before
+        while (firstOpenClause < clauses.size() && clauses[firstOpenClause].literals.size() == 0) {
+            firstOpenClause++;
         }
+
+        allSatisfied = firstOpenClause == clauses.size();
     }
 
     std::cout << "prediction flip: " << flipPredictionModel << std::endl; 
@@ -246,8 +228,264 @@ DecompressionInfo decompressModel(const char* formulaFile, const char* modelFile
         }
     }
 
+    delete heuristic;
+}
+
+//replays every component of the formula with its own heuristic in parallel and assigns the variables of the components
+template<class HeuristicType>
+void replayComponents(const std::vector<Cl>& clauses, const std::vector<std::string>& compressedComponents, std::vector<Assignment>& values, Parser& parser,
+                      const DecompressionSetup& setup) {
+    std::vector<Components::Component> components = Components::split(clauses, values.size(), values);
+
+    if (components.size() != compressedComponents.size()) {
+        throw std::runtime_error("The formula has " + std::to_string(components.size()) + " components, but the compressed model contains "
+                                 + std::to_string(compressedComponents.size()) + ".");
+    }
+
+    //the largest components are started first like in the compression
+    std::vector<std::size_t> order(components.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t x, std::size_t y) {
+        return components[x].clauses.size() > components[y].clauses.size();
+    });
+
+    DecompressionSetup componentSetup = setup;
+    if (setup.componentThreads > 1) {
+        componentSetup.initThreads = 1;
+    }
+
+    Parallel::forEach(order.size(), setup.componentThreads, [&](std::size_t i) {
+        std::size_t index = order[i];
+        Components::Component& component = components[index];
+
+        std::vector<Var> localVariables;
+        localVariables.reserve(component.variables.size());
+        for (unsigned int id = 1; id <= component.variables.size(); id++) {
+            localVariables.push_back(Var(id));
+        }
+
+        Parser::buildOccurenceLists(component.clauses, localVariables, 1);
+        Parser::buildImplicationLists(localVariables, 1);
+
+        std::deque<uint64_t> distances = parser.decodeDistances(compressedComponents[index], setup.genericCompression, setup.golombRiceParameter,
+                                                                Components::encodingSizeBound(component.variables.size()));
+        std::vector<Assignment> localValues(component.variables.size(), Assignment::OPEN);
+        SearchBuffers buffers;
+
+        replayAssignment<HeuristicType>(component.clauses, localVariables, distances, localValues, componentSetup, nullptr, buffers);
+
+        //every variable belongs to one component, so the threads write different values
+        for (unsigned int j = 0; j < component.variables.size(); j++) {
+            values[component.variables[j] - 1] = localValues[j];
+        }
+    });
+}
+
+//decompresses a single model. If the model content is given, the compressed model was read from a container and the model file is only used as its name.
+//The heuristic is a template parameter, so the whole replay is instantiated for every heuristic. The workspace is shared by the models of a batch.
+//If the replayed values are given, they are set to the values of the replay with the ids of the prepared formula, so the model can be used as a reference.
+//Without an output file the model is not written
+template<class HeuristicType>
+DecompressionInfo decompressModel(const char* formulaFile, const char* modelFile, const char* outputFile, DecompressionSetup setup, ParsedFormulaCache& parsedFormulas, Workspace& workspace,
+                                  const std::string* modelContent, std::vector<Assignment>* replayedValues) {
+    //set start time
+    const auto startTime = std::chrono::high_resolution_clock::now();
+
+    Parser parser(formulaFile, modelFile);
+    parser.setModelContent(modelContent);
+
+    //the clauses and the occurence lists are kept in the workspace, they are reused if the model belongs to the same formula as the last model
+    std::vector<Cl>& clauses = workspace.clauses;
+    std::vector<Var>& variables = workspace.variables;
+    InitialScores& initialScores = workspace.initialScores;
+    std::shared_ptr<const ParsedFormula> formula;
+    bool preparedFormula = false;
+    uint64_t formulaHash = 0;
+
+    //the formula has to be prepared with the same modes as for the compression
+    uint32_t flags = parser.readCompressedHeader().flags;
+    setup.fixedPointScores = (flags & CompressionHeader::FIXED_POINT_SCORES) != 0;
+    uint32_t formulaFlags = flags & CompressionHeader::FORMULA_FLAGS;
+
+    //try to restore the parsed formula from the cache
+    if (!setup.formulaCache.empty()) {
+        formulaHash = FormulaCache::variantHash(parsedFormulas.contentHash(formulaFile), formulaFlags);
+        formula = workspace.find(formulaHash);
+
+        if (formula != nullptr) {
+            preparedFormula = true;
+        } else {
+            FormulaCache cache(setup.formulaCache);
+            std::shared_ptr<ParsedFormula> cachedFormula = std::make_shared<ParsedFormula>();
+
+            if (cache.load(formulaHash, clauses, variables, initialScores, cachedFormula->rootLiterals, cachedFormula->substitutions, cachedFormula->originalIds)) {
+                cachedFormula->clauses = clauses;
+                cachedFormula->nrVariables = variables.size();
+                cachedFormula->fingerprint = Parser::formulaFingerprint(clauses, variables.size(), cachedFormula->rootLiterals, cachedFormula->substitutions, cachedFormula->originalIds);
+
+                workspace.assignLoaded(cachedFormula, formulaHash);
+                Parser::buildImplicationLists(variables, setup.initThreads);
+                formula = cachedFormula;
+                preparedFormula = true;
+            }
+        }
+    }
+
+    if (formula == nullptr) {
+        formula = parsedFormulas.get(formulaFile, setup.parserThreads, formulaFlags);
+        preparedFormula = workspace.find(formula) != nullptr;
+    }
+
+    const std::vector<Lit>& rootLiterals = formula->rootLiterals;
+    const std::vector<Equivalences::Substitution>& substitutions = formula->substitutions;
+    const std::vector<unsigned int>& originalIds = formula->originalIds;
+    uint64_t formulaFingerprint = formula->fingerprint;
+
+    CompressionHeader header;
+    std::deque<uint64_t> compresssionDistances;
+    std::vector<std::string> compressedComponents;
+
+    std::string payload = parser.readCompressedPayload(header);
+
+    //a model that was predicted from a reference can only be replayed with the same reference
+    if (header.hasFlag(CompressionHeader::REFERENCE)) {
+        uint64_t referenceHash = ReferenceModel::parseHash(payload);
+
+        if (referenceHash == 0) {
+            setup.reference = nullptr;
+        } else if (setup.reference == nullptr) {
+            throw std::runtime_error("The compressed model " + std::string(modelFile) + " was compressed with a reference model, it has to be given with --reference.");
+        } else if (setup.reference->hash != referenceHash) {
+            throw std::runtime_error("The compressed model " + std::string(modelFile) + " was compressed with a different reference model (hash " + Hash::toHex(referenceHash)
+                                     + " instead of " + Hash::toHex(setup.reference->hash) + ").");
+        }
+    } else {
+        setup.reference = nullptr;
+    }
+
+    //the same holds for the priors, they were trained with the original ids of the formula
+    std::vector<Assignment> priorValues;
+    uint64_t priorsHash = header.hasFlag(CompressionHeader::PRIORS) ? PolarityPriors::parseHash(payload) : 0;
+
+    if (priorsHash != 0) {
+        if (setup.priors == nullptr) {
+            throw std::runtime_error("The compressed model " + std::string(modelFile) + " was compressed with polarity priors, they have to be given with --priors.");
+        } else if (setup.priors->hash != priorsHash) {
+            throw std::runtime_error("The compressed model " + std::string(modelFile) + " was compressed with different polarity priors (hash " + Hash::toHex(priorsHash)
+                                     + " instead of " + Hash::toHex(setup.priors->hash) + ").");
+        }
+
+        setup.priors->check(parsedFormulas.contentHash(formulaFile), formulaFile);
+        priorValues = setup.priors->prepare(originalIds);
+        setup.priorValues = &priorValues;
+    }
+
+    //the heuristic of a portfolio was already selected by decompressWithStoredHeuristic
+    if (header.hasFlag(CompressionHeader::HEURISTIC)) {
+        Portfolio::parseHeuristic(payload);
+    }
+
+    //every encoded stream of a model that was compressed with all codecs starts with the id of its codec
+    if (header.hasFlag(CompressionHeader::CODEC)) {
+        setup.genericCompression = "auto";
+    } else if (setup.genericCompression == "auto") {
+        throw std::runtime_error("The compressed model " + std::string(modelFile) + " was not compressed with the generic compression auto, the compression has to be given with -c.");
+    }
+
+    //the compressed components are decoded by the threads that replay them
+    if (flags & CompressionHeader::COMPONENTS) {
+        compressedComponents = Components::parse(payload);
+    } else {
+        compresssionDistances = parser.decodeDistances(payload, setup.genericCompression, setup.golombRiceParameter, formula->nrVariables * 3);
+    }
+
+    //the replay only reconstructs the model if the formula is the same that was used for the compression
+    if (header.formulaFingerprint != formulaFingerprint) {
+        throw std::runtime_error("The compressed model " + std::string(modelFile) + " was created with a different formula than " + std::string(formulaFile)
+                                 + " (fingerprint " + Hash::toHex(header.formulaFingerprint) + " instead of " + Hash::toHex(formulaFingerprint) + ").");
+    }
+
+    std::cout << "Number of Variables: " << formula->nrVariables << std::endl;
+    std::cout << "Number of Clauses: " << formula->clauses.size() << std::endl;
+    if (header.hasFlag(CompressionHeader::COMPONENTS)) {
+        std::cout << "Number of components: " << compressedComponents.size() << std::endl;
+    } else {
+        std::cout << "Number of distances: " << compresssionDistances.size() << std::endl;
+
+        std::cout << "Diff encoding: ";
+        for (uint32_t i: compresssionDistances) {
+        	std::cout << i << ", ";
+        }
+        std::cout << std::endl;
+    }
+
+     //measure parsing time
+    const auto parsingTime = std::chrono::high_resolution_clock::now();
+
+    if (!preparedFormula) {
+        //copy the clauses into the workspace and build occurence list
+        workspace.assign(formula, formulaHash, setup.initThreads);
+
+        if (!setup.formulaCache.empty()) {
+            initialScores = InitialScores::compute(variables, clauses, setup.initThreads);
+
+            FormulaCache cache(setup.formulaCache);
+            cache.store(formulaHash, clauses, variables, initialScores, rootLiterals, substitutions, originalIds);
+        }
+
+        //binary clauses are propagated through the implication lists
+        Parser::buildImplicationLists(variables, setup.initThreads);
+    }
+
+    //the precomputed heuristic values are only available if the formula cache is used
+    const InitialScores* scores = setup.formulaCache.empty() ? nullptr : &initialScores;
+
+    std::vector<Assignment>& values = workspace.values;
+    values.assign(variables.size(), Assignment::OPEN);
+
+    //start from the assignments of the root propagation like the compression
+    for (Lit lit: rootLiterals) {
+        values[lit.id - 1] = lit.negative ? Assignment::FALSE : Assignment::TRUE;
+    }
+
+    //the substituted variables are skipped like in the compression, their values are restored after the replay
+    for (const Equivalences::Substitution& substitution: substitutions) {
+        values[substitution.variable - 1] = Assignment::TRUE;
+    }
+
+    if (header.hasFlag(CompressionHeader::COMPONENTS)) {
+        replayComponents<HeuristicType>(clauses, compressedComponents, values, parser, setup);
+    } else {
+        replayAssignment<HeuristicType>(clauses, variables, compresssionDistances, values, setup, scores, workspace.search);
+    }
+
+    if (replayedValues != nullptr) {
+        *replayedValues = values;
+    }
+
+    //the substituted variables get the values of their literals. A literal that is a don't care is assigned,
+    //because the binary clauses that made the variables equivalent are not part of the formula anymore
+    for (const Equivalences::Substitution& substitution: substitutions) {
+        Lit lit = substitution.literal;
+
+        if (values[lit.id - 1] == Assignment::OPEN) {
+            values[lit.id - 1] = Assignment::TRUE;
+        }
+
+        values[substitution.variable - 1] = Equivalences::value(substitution, values[lit.id - 1]);
+    }
+
+    //the model is written with the original ids
+    if (!originalIds.empty()) {
+        values = Renumbering::restore(values, originalIds);
+    }
+
 
     //write the decompressed model to the output file
+    if (outputFile == nullptr) {
+        return DecompressionInfo(clauses.size(), variables.size(), 0, 0);
+    }
+
     std::ofstream outputFileStream(outputFile);
 
     outputFileStream << "v ";
@@ -273,8 +511,6 @@ DecompressionInfo decompressModel(const char* formulaFile, const char* modelFile
     outputFileStream << "\n";
     outputFileStream.close();
 
-    delete heuristic;
-
     //get overall execution time
     const auto overallTime = std::chrono::high_resolution_clock::now();
 
@@ -288,6 +524,58 @@ DecompressionInfo decompressModel(const char* formulaFile, const char* modelFile
 
 }
 
+typedef DecompressionInfo (*DecompressionFunction)(const char*, const char*, const char*, DecompressionSetup, ParsedFormulaCache&, Workspace&, const std::string*, std::vector<Assignment>*);
+
+//selects the decompression for the heuristic once, the returned function contains the replay for this heuristic
+DecompressionFunction selectDecompression(const DecompressionSetup& setup) {
+    if (setup.heuristic == "none") {
+        return decompressModel<ParsingOrder>;
+    } else if (setup.heuristic == "jewa") {
+        return decompressModel<JeroslowWang<false>>;
+    } else if (setup.heuristic == "jewa_dyn") {
+        return decompressModel<JeroslowWang<true>>;
+    } else if (setup.heuristic == "moms") {
+        return decompressModel<MomsFreeman<false>>;
+    } else if (setup.heuristic == "moms_dyn") {
+        return decompressModel<MomsFreeman<true>>;
+    } else if (setup.heuristic == "hybr") {
+        return decompressModel<HybridHeuristic<false>>;
+    } else if (setup.heuristic == "hybr_dyn") {
+        return decompressModel<HybridHeuristic<true>>;
+    }
+
+    throw std::runtime_error("Unknown heuristic: " + setup.heuristic);
+}
+
+std::string readCompressedModel(const std::string& filename) {
+    std::ifstream input(filename, std::ios::binary);
+    std::stringstream buffer;
+    buffer << input.rdbuf();
+    return buffer.str();
+}
+
+//decompresses a model that was compressed with a portfolio of heuristics with the heuristic that is stored in it, the other models are
+//decompressed with the heuristic of the setup. The compressed model is only read once, it is passed on as the model content
+DecompressionInfo decompressWithStoredHeuristic(const char* formulaFile, const char* modelFile, const char* outputFile, DecompressionSetup setup, ParsedFormulaCache& parsedFormulas,
+                                                Workspace& workspace, const std::string* modelContent, std::vector<Assignment>* replayedValues) {
+    Parser parser(formulaFile, modelFile);
+    parser.setModelContent(modelContent);
+
+    if (!parser.readCompressedHeader().hasFlag(CompressionHeader::HEURISTIC)) {
+        if (setup.heuristic == "auto") {
+            throw std::runtime_error("The compressed model " + std::string(modelFile) + " was not compressed with a portfolio of heuristics, the heuristic has to be given with -h.");
+        }
+
+        return selectDecompression(setup)(formulaFile, modelFile, outputFile, setup, parsedFormulas, workspace, modelContent, replayedValues);
+    }
+
+    std::string compressedModel = modelContent != nullptr ? *modelContent : readCompressedModel(modelFile);
+    CompressionHeader header = CompressionHeader::parse(compressedModel);
+    setup.heuristic = Portfolio::peekHeuristic(header, compressedModel.substr(header.size()));
+    std::cout << "Heuristic of the portfolio: " << setup.heuristic << std::endl;
+
+    return selectDecompression(setup)(formulaFile, modelFile, outputFile, setup, parsedFormulas, workspace, &compressedModel, replayedValues);
+}
 
 int main(int argc, char** argv) {
     if (argc < 4) {
@@ -301,6 +589,8 @@ int main(int argc, char** argv) {
     fs::path outputPath(argv[3]);
 
     DecompressionSetup setup;
+    ParsedFormulaCache parsedFormulas;
+    Workspace workspace;
 
     if (argc > 4) {
         for (int i = 4; i < argc; i += 2) {
@@ -318,17 +608,115 @@ int main(int argc, char** argv) {
                 setup.predictionFlip = std::stoi(argv[i + 1]);
             } else if (argString == "-hp") {
                 setup.hybridHeuristicParam = std::stoi(argv[i + 1]);
+            } else if (argString == "-pt") {
+                setup.parserThreads = std::stoi(argv[i + 1]);
+            } else if (argString == "-it") {
+                setup.initThreads = std::stoi(argv[i + 1]);
+            } else if (argString == "--formula-cache") {
+                setup.formulaCache = std::string(argv[i + 1]);
+            } else if (argString == "--model") {
+                setup.containerModel = std::string(argv[i + 1]);
+            } else if (argString == "-ct") {
+                setup.componentThreads = std::stoi(argv[i + 1]);
+            } else if (argString == "--reference") {
+                setup.referenceModel = std::string(argv[i + 1]);
+            } else if (argString == "--priors") {
+                setup.priorsPath = std::string(argv[i + 1]);
             } else {
                 throw std::runtime_error("Unknown argment: " + argString);
             }
         }
     }
 
-    //input is files so only one compression has to be done
-    if (fs::is_regular_file(formulaPath) && fs::is_regular_file(modelPath)) {
+    //the heuristic is checked once, models of a portfolio are decompressed with their stored heuristic
+    if (setup.heuristic != "auto") {
+        selectDecompression(setup);
+    }
+    DecompressionFunction decompress = decompressWithStoredHeuristic;
+
+    //loads the priors of an instance from the priors directory, an instance without a priors file is decompressed without priors
+    auto loadPriors = [&](const std::string& instanceName) {
+        setup.priors = nullptr;
+
+        fs::path priorsFile = setup.priorsPath;
+        priorsFile.append(instanceName + ".priors");
+
+        if (!setup.priorsPath.empty() && fs::is_regular_file(priorsFile)) {
+            setup.priors = std::make_shared<const PolarityPriors>(PolarityPriors::read(priorsFile));
+        }
+    };
+
+    //a single model or a single container is decompressed with the given priors file
+    if (!setup.priorsPath.empty() && fs::is_regular_file(modelPath)) {
+        setup.priors = std::make_shared<const PolarityPriors>(PolarityPriors::read(setup.priorsPath));
+    }
+
+    //decompresses the reference model of an instance, the following models of the instance are replayed with its values. Without an output file the reference is not written
+    auto decompressReference = [&](const std::string& instanceFile, const std::string& modelName, const char* outputFile, const std::string& compressedReference) {
+        std::cout << "Decompress reference model: " << modelName << std::endl;
+
+        setup.reference = nullptr;
+        std::vector<Assignment> referenceValues;
+        DecompressionInfo info = decompress(instanceFile.c_str(), modelName.c_str(), outputFile, setup, parsedFormulas, workspace, &compressedReference, &referenceValues);
+        setup.reference = std::make_shared<const ReferenceModel>(std::move(referenceValues), compressedReference);
+
+        return info;
+    };
+
+    //extract the models of a container, either a single named model into the output file or all models into the output directory
+    if (fs::is_regular_file(formulaPath) && fs::is_regular_file(modelPath) && ModelContainer::Reader::isContainer(modelPath)) {
+        ModelContainer::Reader container(modelPath);
+
+        if (!setup.containerModel.empty()) {
+            if (!setup.referenceModel.empty() && setup.referenceModel != setup.containerModel) {
+                decompressReference(argv[1], std::string(argv[2]) + ":" + setup.referenceModel, nullptr, container.read(setup.referenceModel));
+            }
+
+            std::string compressedModel = container.read(setup.containerModel);
+            std::string modelName = std::string(argv[2]) + ":" + setup.containerModel;
+
+            std::cout << "Decompress model: " << modelName << std::endl;
+
+            decompress(argv[1], modelName.c_str(), argv[3], setup, parsedFormulas, workspace, &compressedModel, nullptr);
+        } else if (fs::is_directory(outputPath)) {
+            container.map();
+
+            //the reference is decompressed first, as the other models are replayed with its values
+            std::vector<ModelContainer::Entry> entries = container.getEntries();
+            std::stable_partition(entries.begin(), entries.end(), [&](const ModelContainer::Entry& entry) { return entry.name == setup.referenceModel; });
+
+            for (const ModelContainer::Entry& entry: entries) {
+                std::string compressedModel = container.read(entry);
+                std::string modelName = std::string(argv[2]) + ":" + entry.name;
+
+                fs::path outputFile = outputPath;
+                outputFile.append(entry.name);
+                std::string outputFileString(outputFile);
+
+                if (entry.name == setup.referenceModel) {
+                    decompressReference(argv[1], modelName, outputFileString.c_str(), compressedModel);
+                    continue;
+                }
+
+                std::cout << "Decompress model: " << modelName << std::endl;
+
+                decompress(argv[1], modelName.c_str(), outputFileString.c_str(), setup, parsedFormulas, workspace, &compressedModel, nullptr);
+            }
+        } else {
+            throw std::runtime_error("The output path must be a directory if no model of the container is selected with --model.");
+        }
+
+        std::cout << "Done." << std::endl;
+        return 0;
+    } else if (fs::is_regular_file(formulaPath) && fs::is_regular_file(modelPath)) {
+        //input is files so only one compression has to be done
+        if (!setup.referenceModel.empty() && !fs::equivalent(setup.referenceModel, modelPath)) {
+            decompressReference(argv[1], setup.referenceModel, nullptr, readCompressedModel(setup.referenceModel));
+        }
+
         std::cout << "Decompress model: " << modelPath << std::endl;
         
-        decompressModel(argv[1], argv[2], argv[3], setup);
+        decompress(argv[1], argv[2], argv[3], setup, parsedFormulas, workspace, nullptr, nullptr);
 
         std::cout << "Done." << std::endl;
         return 0;
@@ -340,7 +728,49 @@ int main(int argc, char** argv) {
 
         for (fs::directory_entry modelsEntry: modelIterator) {
 
-            if (modelsEntry.is_directory()) {
+            //the container of an instance is named after the instance and contains all of its models
+            if (modelsEntry.is_regular_file() && modelsEntry.path().extension() == ".pmc") {
+                std::string instanceName = modelsEntry.path().stem();
+
+                fs::path instancePath = formulaPath;
+                instancePath.append(instanceName);
+                instancePath.replace_extension(".cnf");
+                std::string instanceFileString(instancePath);
+
+                //create new output folder
+                fs::path outputSubdirectory = outputPath;
+                outputSubdirectory.append(instanceName);
+                fs::create_directory(outputSubdirectory);
+
+                ModelContainer::Reader container(modelsEntry.path());
+                container.map();
+
+                loadPriors(instanceName);
+
+                //the reference is decompressed first, as the other models are replayed with its values
+                setup.reference = nullptr;
+                std::vector<ModelContainer::Entry> entries = container.getEntries();
+                std::stable_partition(entries.begin(), entries.end(), [&](const ModelContainer::Entry& entry) { return entry.name == setup.referenceModel; });
+
+                for (const ModelContainer::Entry& entry: entries) {
+                    std::string compressedModel = container.read(entry);
+                    std::string modelFileString = std::string(modelsEntry.path()) + ":" + entry.name;
+
+                    fs::path outputFile = outputSubdirectory;
+                    outputFile.append(entry.name);
+                    std::string outputFileString(outputFile);
+
+                    std::cout << "Deompress model: " << modelFileString << std::endl;
+
+                    DecompressionInfo info = entry.name == setup.referenceModel
+                        ? decompressReference(instanceFileString, modelFileString, outputFileString.c_str(), compressedModel)
+                        : decompress(instanceFileString.c_str(), modelFileString.c_str(), outputFileString.c_str(), setup, parsedFormulas, workspace, &compressedModel, nullptr);
+                    info.addNames(instanceName, entry.name);
+                    infos.push_back(info);
+
+                    std::cout << "Done." << std::endl;
+                }
+            } else if (modelsEntry.is_directory()) {
                 std::string instanceName = modelsEntry.path().filename();
 
                 fs::path instancePath = formulaPath;
@@ -352,20 +782,31 @@ int main(int argc, char** argv) {
                 outputSubdirectory.append(instanceName);
                 fs::create_directory(outputSubdirectory);
 
-                //iterate over all models in the folder and compress them
+                //the reference is decompressed first, as the other models are replayed with its values
+                std::vector<fs::path> modelFiles;
                 for(fs::directory_entry model: fs::directory_iterator{modelsEntry.path()}) {
+                    modelFiles.push_back(model.path());
+                }
+                std::stable_partition(modelFiles.begin(), modelFiles.end(), [&](const fs::path& model) { return model.filename() == setup.referenceModel; });
+                setup.reference = nullptr;
+                loadPriors(instanceName);
+
+                //iterate over all models in the folder and compress them
+                for(const fs::path& model: modelFiles) {
                     std::string instanceFileString(instancePath);
-                    std::string modelFileString(model.path());
+                    std::string modelFileString(model);
 
                     //get output file
-                    std::string modelName = model.path().filename();
+                    std::string modelName = model.filename();
                     fs::path outputFile = outputSubdirectory;
                     outputFile.append(modelName);
                     std::string outputFileString(outputFile);
 
-                    std::cout << "Deompress model: " << model.path() << std::endl;
+                    std::cout << "Deompress model: " << model << std::endl;
 
-                    DecompressionInfo info = decompressModel(instanceFileString.c_str(), modelFileString.c_str(), outputFileString.c_str(), setup);
+                    DecompressionInfo info = modelName == setup.referenceModel
+                        ? decompressReference(instanceFileString, modelFileString, outputFileString.c_str(), readCompressedModel(modelFileString))
+                        : decompress(instanceFileString.c_str(), modelFileString.c_str(), outputFileString.c_str(), setup, parsedFormulas, workspace, nullptr, nullptr);
                     info.addNames(instanceName, modelName);
                     infos.push_back(info);
 
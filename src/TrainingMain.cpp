@@ -0,0 +1,163 @@
+#include <iostream>
+#include <filesystem>
+#include <vector>
+#include <string>
+
+#include "Parser.h"
+#include "SATTypes.h"
+#include "Heuristics.h"
+#include "ParsedFormulaCache.h"
+#include "PolarityPriors.h"
+
+namespace fs = std::filesystem;
+
+thread_local std::map<unsigned int, double> Heuristic::heuristicValues;
+thread_local std::map<unsigned int, FixedPoint::Score> Heuristic::fixedPointValues;
+thread_local bool Heuristic::compareFixedPoint = false;
+
+struct TrainingSetup
+{
+    //a variable only gets a prior if this fraction of the models that assign it agree on its value
+    double minConfidence;
+
+    explicit TrainingSetup() : minConfidence(0.5) {}
+};
+
+//number of models in which every variable is true and false
+struct PolarityCounts {
+    std::vector<uint32_t> positive;
+    std::vector<uint32_t> negative;
+    uint32_t nrModels = 0;
+
+    explicit PolarityCounts(unsigned int nrVariables) : positive(nrVariables, 0), negative(nrVariables, 0) {}
+
+    //the variables of the model that are not part of the formula are ignored
+    void add(const Model& model) {
+        for (unsigned int id = 1; id <= positive.size(); id++) {
+            if (!model.contains(id)) {
+                continue;
+            }
+
+            if (model.get(id) == Assignment::TRUE) {
+                positive[id - 1] += 1;
+            } else {
+                negative[id - 1] += 1;
+            }
+        }
+
+        nrModels += 1;
+    }
+
+    //the majority value of every variable whose confidence reaches the minimum. A tie gives no prior,
+    //so the variable keeps the prediction of the heuristic
+    PolarityPriors priors(uint64_t formulaHash, double minConfidence, unsigned int& nrPriors, double& sumConfidence) const {
+        PolarityPriors priors;
+        priors.formulaHash = formulaHash;
+        priors.nrModels = nrModels;
+        priors.values.assign(positive.size(), Assignment::OPEN);
+
+        for (std::size_t i = 0; i < positive.size(); i++) {
+            uint32_t total = positive[i] + negative[i];
+            if (total == 0 || positive[i] == negative[i]) {
+                continue;
+            }
+
+            double confidence = static_cast<double>(std::max(positive[i], negative[i])) / total;
+            if (confidence < minConfidence) {
+                continue;
+            }
+
+            priors.values[i] = positive[i] > negative[i] ? Assignment::TRUE : Assignment::FALSE;
+            nrPriors += 1;
+            sumConfidence += confidence;
+        }
+
+        return priors;
+    }
+};
+
+//trains the priors of the formula on all models of the model directory and writes them to the output file
+void train(const char* formulaFile, const fs::path& modelDirectory, const std::string& outputFile, const TrainingSetup& setup, ParsedFormulaCache& parsedFormulas) {
+    //only the header of the formula is read, the models are read with its number of variables
+    Parser formulaParser(formulaFile, "");
+    unsigned int nrVariables = formulaParser.readVariables().size();
+    PolarityCounts counts(nrVariables);
+
+    for (fs::directory_entry model: fs::directory_iterator{modelDirectory}) {
+        if (!model.is_regular_file()) {
+            continue;
+        }
+
+        std::string modelFileString(model.path());
+        std::cout << "Read model: " << modelFileString << std::endl;
+
+        Parser parser(formulaFile, modelFileString.c_str());
+        counts.add(parser.readModel(nrVariables));
+    }
+
+    unsigned int nrPriors = 0;
+    double sumConfidence = 0;
+    PolarityPriors priors = counts.priors(parsedFormulas.contentHash(formulaFile), setup.minConfidence, nrPriors, sumConfidence);
+    priors.write(outputFile);
+
+    std::cout << "Trained priors for " << nrPriors << " of " << nrVariables << " variables on " << counts.nrModels << " models";
+    if (nrPriors != 0) {
+        std::cout << ", average confidence " << sumConfidence / nrPriors;
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        throw std::runtime_error("Wrong number of arguments: " + std::to_string(argc - 1) + ", expected at least 3 arguments.");
+    } else if ((argc % 2) != 0) {
+        throw std::runtime_error("Wrong number of arguments.");
+    }
+
+    fs::path formulaPath(argv[1]);
+    fs::path modelPath(argv[2]);
+    fs::path outputPath(argv[3]);
+
+    TrainingSetup setup;
+    ParsedFormulaCache parsedFormulas;
+
+    for (int i = 4; i < argc; i += 2) {
+        std::string argString = std::string(argv[i]);
+
+        if (argString == "--min-confidence") {
+            setup.minConfidence = atof(argv[i + 1]);
+        } else {
+            throw std::runtime_error("Unknown argment: " + argString);
+        }
+    }
+
+    if (fs::is_regular_file(formulaPath) && fs::is_directory(modelPath)) {
+        //the models of a single formula are trained into the output file
+        train(argv[1], modelPath, argv[3], setup, parsedFormulas);
+    } else if (fs::is_directory(formulaPath) && fs::is_directory(modelPath) && fs::is_directory(outputPath)) {
+        //every subdirectory of the models directory contains the models of the instance with the same name
+        for (fs::directory_entry modelsEntry: fs::directory_iterator(modelPath)) {
+            if (!modelsEntry.is_directory()) {
+                continue;
+            }
+
+            std::string instanceName = modelsEntry.path().filename();
+
+            fs::path instancePath = formulaPath;
+            instancePath.append(instanceName);
+            instancePath.replace_extension(".cnf");
+            std::string instanceFileString(instancePath);
+
+            fs::path outputFile = outputPath;
+            outputFile.append(instanceName + ".priors");
+
+            std::cout << "Train priors of instance: " << instanceName << std::endl;
+            train(instanceFileString.c_str(), modelsEntry.path(), outputFile, setup, parsedFormulas);
+        }
+    } else {
+        throw std::runtime_error("Wrong Arguments. Arguments must be either a formula file and a model directory or directories.");
+    }
+
+    std::cout << "Done." << std::endl;
+    return 0;
+}
@@ -0,0 +1,93 @@
+#ifndef SRC_PARSER_ARCHIVEREADER_H_
+#define SRC_PARSER_ARCHIVEREADER_H_
+
+#include <archive.h>
+#include <archive_entry.h>
+
+#include <string>
+
+#include "StreamBuffer.h"
+
+//iterates over the regular files of an archive (tar, zip, ...) in a single streaming pass.
+//The archive itself may be compressed with any filter supported by libarchive, e.g. .tar.xz
+class ArchiveReader {
+    private:
+        struct archive* file;
+        std::string filename;
+
+    public:
+        explicit ArchiveReader(const char* filename) : filename(filename) {
+            file = archive_read_new();
+            archive_read_support_filter_all(file);
+            archive_read_support_format_all(file);
+
+            if (archive_read_open_filename(file, filename, 65536) != ARCHIVE_OK) {
+                std::string error(archive_error_string(file));
+                archive_read_free(file);
+                throw ParserException(error + std::string(" Error opening archive: ") + std::string(filename));
+            }
+        }
+
+        ArchiveReader(const ArchiveReader&) = delete;
+        ArchiveReader& operator=(const ArchiveReader&) = delete;
+
+        ~ArchiveReader() {
+            archive_read_free(file);
+        }
+
+        //checks if the file is an archive with multiple entries and not just a single (compressed) file
+        static bool isArchive(const char* filename) {
+            struct archive* file = archive_read_new();
+            archive_read_support_filter_all(file);
+            archive_read_support_format_all(file);
+
+            bool archive = false;
+            struct archive_entry* entry;
+
+            if (archive_read_open_filename(file, filename, 16384) == ARCHIVE_OK) {
+                archive = archive_read_next_header(file, &entry) == ARCHIVE_OK;
+            }
+            archive_read_free(file);
+
+            return archive;
+        }
+
+        //reads the next regular file of the archive, returns false if the end of the archive is reached
+        bool nextEntry(std::string& path, std::string& content) {
+            struct archive_entry* entry;
+            int result;
+
+            while ((result = archive_read_next_header(file, &entry)) == ARCHIVE_OK) {
+                if (archive_entry_filetype(entry) != AE_IFREG) {
+                    continue;
+                }
+
+                path = archive_entry_pathname(entry);
+                content.clear();
+
+                if (archive_entry_size_is_set(entry)) {
+                    content.reserve(archive_entry_size(entry));
+                }
+
+                char chunk[65536];
+                la_ssize_t readBytes;
+                while ((readBytes = archive_read_data(file, chunk, sizeof(chunk))) > 0) {
+                    content.append(chunk, readBytes);
+                }
+
+                if (readBytes < 0) {
+                    throw ParserException(std::string("Error reading ") + path + std::string(" from archive: ") + filename);
+                }
+
+                return true;
+            }
+
+            if (result != ARCHIVE_EOF) {
+                throw ParserException(std::string(archive_error_string(file)) + std::string(" Error reading archive: ") + filename);
+            }
+
+            return false;
+        }
+};
+
+#endif
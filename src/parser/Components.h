@@ -0,0 +1,169 @@
+#ifndef SRC_PARSER_COMPONENTS_H_
+#define SRC_PARSER_COMPONENTS_H_
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+#include "SATTypes.h"
+
+//decomposition of the formula into the connected components of the variables. The components share no clauses, so every
+//component is compressed with its own heuristic and the compressed components are stored one after another behind a table
+namespace Components {
+
+    struct Component {
+        //the variables of the component in increasing order, the variable at position i has the local id i + 1
+        std::vector<unsigned int> variables;
+        //the clauses of the component in their original order with the local ids of the variables
+        std::vector<Cl> clauses;
+    };
+
+    inline unsigned int find(std::vector<unsigned int>& parents, unsigned int variable) {
+        while (parents[variable] != variable) {
+            parents[variable] = parents[parents[variable]];
+            variable = parents[variable];
+        }
+
+        return variable;
+    }
+
+    //splits the formula into its components, they are ordered by their smallest variable. The variables that do not occur in
+    //the clauses and are not assigned yet form an additional component without clauses at the end
+    inline std::vector<Component> split(const std::vector<Cl>& clauses, unsigned int nrVariables, const std::vector<Assignment>& values) {
+        std::vector<unsigned int> parents(nrVariables);
+        std::iota(parents.begin(), parents.end(), 0);
+        std::vector<bool> occurs(nrVariables, false);
+
+        //union find over the variables of every clause, the smaller root becomes the parent
+        for (const Cl& clause: clauses) {
+            for (Lit lit: clause.literals) {
+                occurs.at(lit.id - 1) = true;
+
+                unsigned int x = find(parents, clause.literals[0].id - 1);
+                unsigned int y = find(parents, lit.id - 1);
+
+                if (x != y) {
+                    parents[std::max(x, y)] = std::min(x, y);
+                }
+            }
+        }
+
+        const unsigned int NO_COMPONENT = static_cast<unsigned int>(-1);
+        std::vector<unsigned int> componentIndices(nrVariables, NO_COMPONENT);
+        std::vector<unsigned int> localIds(nrVariables, 0);
+        std::vector<Component> components;
+        Component freeVariables;
+
+        for (unsigned int i = 0; i < nrVariables; i++) {
+            if (!occurs[i]) {
+                if (values[i] == Assignment::OPEN) {
+                    freeVariables.variables.push_back(i + 1);
+                }
+                continue;
+            }
+
+            unsigned int root = find(parents, i);
+            if (componentIndices[root] == NO_COMPONENT) {
+                componentIndices[root] = components.size();
+                components.emplace_back();
+            }
+
+            Component& component = components[componentIndices[root]];
+            component.variables.push_back(i + 1);
+            localIds[i] = component.variables.size();
+        }
+
+        for (const Cl& clause: clauses) {
+            //an empty clause belongs to no component
+            if (clause.literals.empty()) {
+                continue;
+            }
+
+            Cl localClause;
+            for (Lit lit: clause.literals) {
+                localClause.addLiteral(Lit(localIds[lit.id - 1], lit.negative));
+            }
+
+            components[componentIndices[find(parents, clause.literals[0].id - 1)]].clauses.push_back(std::move(localClause));
+        }
+
+        if (!freeVariables.variables.empty()) {
+            components.push_back(std::move(freeVariables));
+        }
+
+        return components;
+    }
+
+    //the part of the model that assigns the variables of the component, with the local ids
+    inline Model project(const Component& component, const Model& model) {
+        Model localModel(component.variables.size());
+
+        for (unsigned int i = 0; i < component.variables.size(); i++) {
+            unsigned int id = component.variables[i];
+
+            if (model.contains(id)) {
+                localModel.assign(ModelVar(model.get(id) == Assignment::TRUE ? static_cast<int>(i + 1) : -static_cast<int>(i + 1)));
+            }
+        }
+
+        return localModel;
+    }
+
+    //upper bound of the size of the decompressed encoding of a component. It contains at most one distance and one
+    //don't care variable per variable and every number is at most the number of variables
+    inline std::size_t encodingSizeBound(std::size_t nrVariables) {
+        return (2 * nrVariables + 2) * (std::to_string(nrVariables).size() + 1);
+    }
+
+    //writes the number of components and the length of every compressed component followed by the compressed components
+    inline std::string serialize(const std::vector<std::string>& compressedComponents) {
+        uint32_t nrComponents = compressedComponents.size();
+        std::string output(reinterpret_cast<const char*>(&nrComponents), sizeof(nrComponents));
+
+        for (const std::string& compressedComponent: compressedComponents) {
+            uint64_t length = compressedComponent.size();
+            output.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        }
+
+        for (const std::string& compressedComponent: compressedComponents) {
+            output.append(compressedComponent);
+        }
+
+        return output;
+    }
+
+    inline std::vector<std::string> parse(const std::string& input) {
+        uint32_t nrComponents;
+        if (input.size() < sizeof(nrComponents)) {
+            throw std::runtime_error("The component table of the compressed model is corrupted.");
+        }
+        std::memcpy(&nrComponents, input.data(), sizeof(nrComponents));
+
+        std::size_t position = sizeof(nrComponents) + static_cast<std::size_t>(nrComponents) * sizeof(uint64_t);
+        if (input.size() < position) {
+            throw std::runtime_error("The component table of the compressed model is corrupted.");
+        }
+
+        std::vector<std::string> compressedComponents;
+        compressedComponents.reserve(nrComponents);
+
+        for (uint32_t i = 0; i < nrComponents; i++) {
+            uint64_t length;
+            std::memcpy(&length, input.data() + sizeof(nrComponents) + i * sizeof(uint64_t), sizeof(length));
+
+            if (length > input.size() - position) {
+                throw std::runtime_error("The component table of the compressed model is corrupted.");
+            }
+
+            compressedComponents.push_back(input.substr(position, length));
+            position += length;
+        }
+
+        return compressedComponents;
+    }
+}
+
+#endif
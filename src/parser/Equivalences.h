@@ -0,0 +1,193 @@
+#ifndef SRC_PARSER_EQUIVALENCES_H_
+#define SRC_PARSER_EQUIVALENCES_H_
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "SATTypes.h"
+
+//substitution of equivalent literals. The strongly connected components of the binary implication graph contain literals
+//that have the same value in every model, every literal is replaced by the literal of its component with the smallest variable id.
+//The result only depends on the clauses and their order, so the compression and the decompression substitute the same variables
+namespace Equivalences {
+
+    //the variable is replaced by the literal in the formula, its value is the value of the literal
+    struct Substitution {
+        unsigned int variable;
+        Lit literal;
+    };
+
+    //the positive literal of variable v has the index 2 * (v - 1), the negative one 2 * (v - 1) + 1
+    inline std::size_t literalIndex(Lit lit) {
+        return 2 * (lit.id - 1) + lit.negative;
+    }
+
+    inline Lit indexLiteral(std::size_t index) {
+        return Lit(index / 2 + 1, index % 2 != 0);
+    }
+
+    //finds the strongly connected components of the implication graph of the binary clauses with Tarjan's algorithm.
+    //The algorithm is iterative, the implication chains of large formulas are too long for the call stack.
+    //Returns the representative literal of every literal
+    inline std::vector<Lit> findRepresentatives(const std::vector<Cl>& clauses, unsigned int nrVariables) {
+        std::size_t nrLiterals = 2 * static_cast<std::size_t>(nrVariables);
+
+        //the binary clause (a, b) contains the implications -a -> b and -b -> a
+        std::vector<std::size_t> offsets(nrLiterals + 1, 0);
+        for (const Cl& clause: clauses) {
+            if (clause.literals.size() == 2) {
+                offsets.at(literalIndex(~clause.literals[0]) + 1) += 1;
+                offsets.at(literalIndex(~clause.literals[1]) + 1) += 1;
+            }
+        }
+
+        for (std::size_t i = 1; i < offsets.size(); i++) {
+            offsets[i] += offsets[i - 1];
+        }
+
+        std::vector<std::size_t> edges(offsets.back());
+        std::vector<std::size_t> positions(offsets.begin(), offsets.end() - 1);
+        for (const Cl& clause: clauses) {
+            if (clause.literals.size() == 2) {
+                edges[positions[literalIndex(~clause.literals[0])]++] = literalIndex(clause.literals[1]);
+                edges[positions[literalIndex(~clause.literals[1])]++] = literalIndex(clause.literals[0]);
+            }
+        }
+
+        const std::size_t UNVISITED = static_cast<std::size_t>(-1);
+        std::vector<std::size_t> order(nrLiterals, UNVISITED);
+        std::vector<std::size_t> lowLink(nrLiterals, 0);
+        std::vector<bool> onStack(nrLiterals, false);
+        std::vector<std::size_t> stack;
+        //literal and position of the next edge of every literal on the path of the depth first search
+        std::vector<std::pair<std::size_t, std::size_t>> path;
+        std::size_t nextOrder = 0;
+
+        std::vector<Lit> representatives;
+        representatives.reserve(nrLiterals);
+        for (std::size_t i = 0; i < nrLiterals; i++) {
+            representatives.push_back(indexLiteral(i));
+        }
+
+        for (std::size_t root = 0; root < nrLiterals; root++) {
+            if (order[root] != UNVISITED || offsets[root] == offsets[root + 1]) {
+                continue;
+            }
+
+            order[root] = lowLink[root] = nextOrder++;
+            stack.push_back(root);
+            onStack[root] = true;
+            path.emplace_back(root, offsets[root]);
+
+            while (!path.empty()) {
+                std::size_t literal = path.back().first;
+                std::size_t& edge = path.back().second;
+
+                if (edge < offsets[literal + 1]) {
+                    std::size_t next = edges[edge++];
+
+                    if (order[next] == UNVISITED) {
+                        order[next] = lowLink[next] = nextOrder++;
+                        stack.push_back(next);
+                        onStack[next] = true;
+                        path.emplace_back(next, offsets[next]);
+                    } else if (onStack[next]) {
+                        lowLink[literal] = std::min(lowLink[literal], order[next]);
+                    }
+                    continue;
+                }
+
+                path.pop_back();
+
+                if (!path.empty()) {
+                    std::size_t parent = path.back().first;
+                    lowLink[parent] = std::min(lowLink[parent], lowLink[literal]);
+                }
+
+                if (lowLink[literal] != order[literal]) {
+                    continue;
+                }
+
+                //the literal is the root of a component, its members are on top of the stack
+                std::vector<std::size_t>::iterator begin = std::find(stack.rbegin(), stack.rend(), literal).base() - 1;
+                //both literals of a variable have neighboring indices, so the smallest index also has the smallest variable id
+                std::size_t representative = *std::min_element(begin, stack.end());
+
+                for (std::vector<std::size_t>::iterator it = begin; it != stack.end(); it++) {
+                    representatives[*it] = indexLiteral(representative);
+                    onStack[*it] = false;
+                }
+
+                stack.erase(begin, stack.end());
+            }
+        }
+
+        return representatives;
+    }
+
+    //replaces every literal by its representative. Duplicate literals are removed and clauses that become tautologies are
+    //removed, the remaining clauses keep their order. Returns the substituted variables in increasing order
+    inline std::vector<Substitution> substitute(std::vector<Cl>& clauses, unsigned int nrVariables) {
+        std::vector<Lit> representatives = findRepresentatives(clauses, nrVariables);
+
+        std::vector<Substitution> substitutions;
+        for (unsigned int i = 1; i <= nrVariables; i++) {
+            Lit representative = representatives[literalIndex(Lit(i, false))];
+
+            //the negative literal is in the component of the negated literals, unless both literals are in the same component
+            if (!(representatives[literalIndex(Lit(i, true))] == ~representative)) {
+                throw std::runtime_error("The formula is unsatisfiable, a variable is equivalent to its negation.");
+            }
+
+            if (representative.id != i) {
+                substitutions.push_back(Substitution{i, representative});
+            }
+        }
+
+        if (substitutions.empty()) {
+            return substitutions;
+        }
+
+        std::vector<Cl> substituted;
+        substituted.reserve(clauses.size());
+
+        for (const Cl& clause: clauses) {
+            Cl result;
+            bool tautology = false;
+
+            for (Lit lit: clause.literals) {
+                Lit representative = representatives[literalIndex(lit)];
+
+                if (result.containsLiteral(~representative)) {
+                    tautology = true;
+                    break;
+                }
+
+                if (!result.containsLiteral(representative)) {
+                    result.addLiteral(representative);
+                }
+            }
+
+            if (!tautology) {
+                substituted.push_back(std::move(result));
+            }
+        }
+
+        clauses = std::move(substituted);
+
+        return substitutions;
+    }
+
+    //value of a substituted variable from the value of its representative
+    inline Assignment value(const Substitution& substitution, Assignment representativeValue) {
+        if (representativeValue == Assignment::OPEN || !substitution.literal.negative) {
+            return representativeValue;
+        }
+
+        return representativeValue == Assignment::TRUE ? Assignment::FALSE : Assignment::TRUE;
+    }
+}
+
+#endif
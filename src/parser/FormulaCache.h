@@ -0,0 +1,319 @@
+#ifndef SRC_PARSER_FORMULACACHE_H_
+#define SRC_PARSER_FORMULACACHE_H_
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <stdexcept>
+#include <cstdlib>
+#include <unistd.h>
+
+#include "SATTypes.h"
+#include "Heuristics.h"
+#include "MappedFile.h"
+#include "Hash.h"
+#include "Equivalences.h"
+
+namespace fs = std::filesystem;
+
+//stores the parsed clauses, the occurence lists and the initial heuristic values of a formula in a binary file.
+//The files are named after the hash of the formula file content and are mapped into memory when they are loaded
+class FormulaCache {
+    private:
+        static constexpr uint32_t VERSION = 4;
+
+        struct Header {
+            char magic[4];
+            uint32_t version;
+            uint64_t contentHash;
+            uint64_t nrVariables;
+            uint64_t nrClauses;
+            uint64_t nrLiterals;
+            uint64_t nrPosOccurences;
+            uint64_t nrNegOccurences;
+            uint32_t minClauseLength;
+            uint32_t nrMinClauses;
+            uint64_t nrRootLiterals;
+            uint64_t nrSubstitutions;
+            uint64_t nrOriginalIds;
+        };
+
+        fs::path directory;
+
+        fs::path cacheFile(uint64_t contentHash) {
+            fs::path path = directory;
+            path.append(Hash::toHex(contentHash));
+            path.replace_extension(".fcache");
+            return path;
+        }
+
+        //all sections are padded to 8 bytes so that every array in the mapped file is aligned
+        static std::size_t padded(std::size_t size) {
+            return (size + 7) & ~static_cast<std::size_t>(7);
+        }
+
+        template<typename T>
+        static void writeSection(std::ofstream& output, const std::vector<T>& values) {
+            output.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+
+            std::size_t padding = padded(values.size() * sizeof(T)) - values.size() * sizeof(T);
+            const char zeros[8] = {0};
+            output.write(zeros, padding);
+        }
+
+        template<typename T>
+        static const T* readSection(const char*& position, std::size_t count) {
+            const T* section = reinterpret_cast<const T*>(position);
+            position += padded(count * sizeof(T));
+            return section;
+        }
+
+    public:
+        //the formula is stored separately for every combination of the modes that change the clauses, e.g. the preprocessing.
+        //The flags have to be masked with CompressionHeader::FORMULA_FLAGS, otherwise the output modes would store copies of the same formula
+        static uint64_t variantHash(uint64_t contentHash, uint32_t flags) {
+            if (flags == 0) {
+                return contentHash;
+            }
+
+            Hash::XXH64 hasher;
+            hasher.updateValue<uint64_t>(contentHash);
+            hasher.updateValue<uint32_t>(flags);
+            return hasher.digest();
+        }
+
+        explicit FormulaCache(std::string directory) : directory(directory) {
+            fs::create_directories(this->directory);
+        }
+
+        //restores the formula from the cache, returns false if no valid cache file exists. The clauses and occurence lists are copied out of
+        //the mapped file on purpose: the search changes the counters of the clauses and the occurence lists point to the clauses, so both need
+        //their own memory. The mapping only saves the tokenizing of the DIMACS file and the computation of the initial scores.
+        //A cache file of the expected size whose offsets or ids are out of range is corrupted and throws an error
+        bool load(uint64_t contentHash, std::vector<Cl>& clauses, std::vector<Var>& variables, InitialScores& scores, std::vector<Lit>& rootLiterals,
+                  std::vector<Equivalences::Substitution>& substitutions, std::vector<unsigned int>& originalIds) {
+            fs::path path = cacheFile(contentHash);
+
+            if (!fs::is_regular_file(path) || fs::file_size(path) < sizeof(Header)) {
+                return false;
+            }
+
+            std::string pathString(path);
+            MappedFile file(pathString.c_str(), false);
+
+            Header header;
+            std::memcpy(&header, file.data(), sizeof(Header));
+
+            if (std::memcmp(header.magic, "PMFC", 4) != 0 || header.version != VERSION || header.contentHash != contentHash) {
+                return false;
+            }
+
+            //counts that are larger than the file can not match its size, this also prevents an overflow of the expected size
+            for (uint64_t count: {header.nrVariables, header.nrClauses, header.nrLiterals, header.nrPosOccurences, header.nrNegOccurences,
+                                  header.nrRootLiterals, header.nrSubstitutions, header.nrOriginalIds}) {
+                if (count > file.size()) {
+                    return false;
+                }
+            }
+
+            std::size_t expectedSize = padded(sizeof(Header)) + padded((header.nrClauses + 1) * sizeof(uint64_t)) + padded(header.nrLiterals * sizeof(int32_t))
+                                     + 2 * padded((header.nrVariables + 1) * sizeof(uint64_t)) + padded(header.nrPosOccurences * sizeof(uint32_t)) + padded(header.nrNegOccurences * sizeof(uint32_t))
+                                     + 2 * padded(header.nrVariables * sizeof(double)) + 2 * padded(header.nrVariables * sizeof(uint32_t))
+                                     + padded(header.nrRootLiterals * sizeof(int32_t)) + padded(2 * header.nrSubstitutions * sizeof(int32_t))
+                                     + padded(header.nrOriginalIds * sizeof(uint32_t));
+
+            if (file.size() != expectedSize) {
+                return false;
+            }
+
+            auto check = [&](bool valid, const std::string& what) {
+                if (!valid) {
+                    throw std::runtime_error("The formula cache file " + pathString + " is corrupted: " + what + " out of range.");
+                }
+            };
+
+            //a literal or a variable id of the cache file, the ids start at one
+            auto checkLiteral = [&](int32_t literal, const std::string& what) {
+                check(literal != 0 && static_cast<uint64_t>(std::abs(static_cast<int64_t>(literal))) <= header.nrVariables, what);
+            };
+
+            check(header.nrOriginalIds == 0 || header.nrOriginalIds == header.nrVariables, "number of original ids");
+
+            const char* position = file.data() + padded(sizeof(Header));
+            const uint64_t* clauseOffsets = readSection<uint64_t>(position, header.nrClauses + 1);
+            const int32_t* literals = readSection<int32_t>(position, header.nrLiterals);
+            const uint64_t* posOffsets = readSection<uint64_t>(position, header.nrVariables + 1);
+            const uint64_t* negOffsets = readSection<uint64_t>(position, header.nrVariables + 1);
+            const uint32_t* posOccurences = readSection<uint32_t>(position, header.nrPosOccurences);
+            const uint32_t* negOccurences = readSection<uint32_t>(position, header.nrNegOccurences);
+            const double* jeroslowWangPos = readSection<double>(position, header.nrVariables);
+            const double* jeroslowWangNeg = readSection<double>(position, header.nrVariables);
+            const uint32_t* momsPosCounts = readSection<uint32_t>(position, header.nrVariables);
+            const uint32_t* momsNegCounts = readSection<uint32_t>(position, header.nrVariables);
+            const int32_t* roots = readSection<int32_t>(position, header.nrRootLiterals);
+            //pairs of the substituted variable and its literal
+            const int32_t* equivalences = readSection<int32_t>(position, 2 * header.nrSubstitutions);
+            const uint32_t* renumbering = readSection<uint32_t>(position, header.nrOriginalIds);
+
+            clauses.clear();
+            clauses.resize(header.nrClauses);
+
+            for (uint64_t i = 0; i < header.nrClauses; i++) {
+                Cl& clause = clauses[i];
+                check(clauseOffsets[i] <= clauseOffsets[i + 1] && clauseOffsets[i + 1] <= header.nrLiterals, "clause offset");
+                clause.literals.reserve(clauseOffsets[i + 1] - clauseOffsets[i]);
+
+                for (uint64_t j = clauseOffsets[i]; j < clauseOffsets[i + 1]; j++) {
+                    checkLiteral(literals[j], "literal");
+                    clause.addLiteral(Lit(abs(literals[j]), literals[j] < 0));
+                }
+            }
+
+            variables.clear();
+            variables.reserve(header.nrVariables);
+
+            for (uint64_t i = 0; i < header.nrVariables; i++) {
+                Var var(i + 1);
+
+                check(posOffsets[i] <= posOffsets[i + 1] && posOffsets[i + 1] <= header.nrPosOccurences, "occurence offset");
+                var.posOccList.reserve(posOffsets[i + 1] - posOffsets[i]);
+                for (uint64_t j = posOffsets[i]; j < posOffsets[i + 1]; j++) {
+                    check(posOccurences[j] < header.nrClauses, "occurence");
+                    var.addPosClause(&clauses[posOccurences[j]]);
+                }
+
+                check(negOffsets[i] <= negOffsets[i + 1] && negOffsets[i + 1] <= header.nrNegOccurences, "occurence offset");
+                var.negOccList.reserve(negOffsets[i + 1] - negOffsets[i]);
+                for (uint64_t j = negOffsets[i]; j < negOffsets[i + 1]; j++) {
+                    check(negOccurences[j] < header.nrClauses, "occurence");
+                    var.addNegClause(&clauses[negOccurences[j]]);
+                }
+
+                variables.push_back(std::move(var));
+            }
+
+            scores.minClauseLength = header.minClauseLength;
+            scores.nrMinClauses = header.nrMinClauses;
+            scores.jeroslowWangPos.assign(jeroslowWangPos, jeroslowWangPos + header.nrVariables);
+            scores.jeroslowWangNeg.assign(jeroslowWangNeg, jeroslowWangNeg + header.nrVariables);
+            scores.momsPosCounts.assign(momsPosCounts, momsPosCounts + header.nrVariables);
+            scores.momsNegCounts.assign(momsNegCounts, momsNegCounts + header.nrVariables);
+
+            rootLiterals.clear();
+            for (uint64_t i = 0; i < header.nrRootLiterals; i++) {
+                checkLiteral(roots[i], "root literal");
+                rootLiterals.push_back(Lit(abs(roots[i]), roots[i] < 0));
+            }
+
+            substitutions.clear();
+            for (uint64_t i = 0; i < header.nrSubstitutions; i++) {
+                int32_t literal = equivalences[2 * i + 1];
+                check(equivalences[2 * i] > 0 && static_cast<uint64_t>(equivalences[2 * i]) <= header.nrVariables, "substituted variable");
+                checkLiteral(literal, "substitution literal");
+                substitutions.push_back(Equivalences::Substitution{static_cast<unsigned int>(equivalences[2 * i]), Lit(abs(literal), literal < 0)});
+            }
+
+            for (uint64_t i = 0; i < header.nrOriginalIds; i++) {
+                check(renumbering[i] != 0 && renumbering[i] <= header.nrVariables, "original id");
+            }
+            originalIds.assign(renumbering, renumbering + header.nrOriginalIds);
+
+            return true;
+        }
+
+        //writes the formula to the cache. The occurence lists must point into the given clauses vector
+        void store(uint64_t contentHash, const std::vector<Cl>& clauses, const std::vector<Var>& variables, const InitialScores& scores, const std::vector<Lit>& rootLiterals,
+                   const std::vector<Equivalences::Substitution>& substitutions, const std::vector<unsigned int>& originalIds) {
+            std::vector<uint64_t> clauseOffsets;
+            std::vector<int32_t> literals;
+            clauseOffsets.reserve(clauses.size() + 1);
+            clauseOffsets.push_back(0);
+
+            for (const Cl& clause: clauses) {
+                for (Lit lit: clause.literals) {
+                    literals.push_back(lit.negative ? -static_cast<int32_t>(lit.id) : static_cast<int32_t>(lit.id));
+                }
+                clauseOffsets.push_back(literals.size());
+            }
+
+            std::vector<uint64_t> posOffsets;
+            std::vector<uint64_t> negOffsets;
+            std::vector<uint32_t> posOccurences;
+            std::vector<uint32_t> negOccurences;
+            posOffsets.push_back(0);
+            negOffsets.push_back(0);
+
+            for (const Var& var: variables) {
+                for (Cl* clause: var.posOccList) {
+                    posOccurences.push_back(clause - clauses.data());
+                }
+                for (Cl* clause: var.negOccList) {
+                    negOccurences.push_back(clause - clauses.data());
+                }
+                posOffsets.push_back(posOccurences.size());
+                negOffsets.push_back(negOccurences.size());
+            }
+
+            Header header;
+            std::memcpy(header.magic, "PMFC", 4);
+            header.version = VERSION;
+            header.contentHash = contentHash;
+            header.nrVariables = variables.size();
+            header.nrClauses = clauses.size();
+            header.nrLiterals = literals.size();
+            header.nrPosOccurences = posOccurences.size();
+            header.nrNegOccurences = negOccurences.size();
+            header.minClauseLength = scores.minClauseLength;
+            header.nrMinClauses = scores.nrMinClauses;
+            header.nrRootLiterals = rootLiterals.size();
+            header.nrSubstitutions = substitutions.size();
+            header.nrOriginalIds = originalIds.size();
+
+            std::vector<int32_t> roots;
+            for (Lit lit: rootLiterals) {
+                roots.push_back(lit.negative ? -static_cast<int32_t>(lit.id) : static_cast<int32_t>(lit.id));
+            }
+
+            std::vector<int32_t> equivalences;
+            for (const Equivalences::Substitution& substitution: substitutions) {
+                Lit lit = substitution.literal;
+                equivalences.push_back(static_cast<int32_t>(substitution.variable));
+                equivalences.push_back(lit.negative ? -static_cast<int32_t>(lit.id) : static_cast<int32_t>(lit.id));
+            }
+
+            //write to a temporary file first so that concurrent runs never see a partially written cache file
+            fs::path path = cacheFile(contentHash);
+            fs::path temporaryPath = path;
+            temporaryPath.replace_extension(".tmp" + std::to_string(getpid()));
+
+            std::ofstream output(temporaryPath, std::ios::binary);
+            std::vector<Header> headerSection(1, header);
+            writeSection(output, headerSection);
+            writeSection(output, clauseOffsets);
+            writeSection(output, literals);
+            writeSection(output, posOffsets);
+            writeSection(output, negOffsets);
+            writeSection(output, posOccurences);
+            writeSection(output, negOccurences);
+            writeSection(output, scores.jeroslowWangPos);
+            writeSection(output, scores.jeroslowWangNeg);
+            writeSection(output, scores.momsPosCounts);
+            writeSection(output, scores.momsNegCounts);
+            writeSection(output, roots);
+            writeSection(output, equivalences);
+            writeSection(output, std::vector<uint32_t>(originalIds.begin(), originalIds.end()));
+            output.close();
+
+            //a failed write must not replace the cache file, e.g. if the disk is full
+            if (!output) {
+                std::error_code error;
+                fs::remove(temporaryPath, error);
+                throw std::runtime_error("Could not write the formula cache file " + std::string(path) + ".");
+            }
+
+            fs::rename(temporaryPath, path);
+        }
+};
+
+#endif
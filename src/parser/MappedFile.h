@@ -0,0 +1,127 @@
+#ifndef SRC_PARSER_MAPPEDFILE_H_
+#define SRC_PARSER_MAPPEDFILE_H_
+
+#include <archive.h>
+#include <archive_entry.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "StreamBuffer.h"
+
+//gives random access to the whole content of a file. Uncompressed files are mapped into memory,
+//compressed files are decompressed into a buffer using libarchive unless the detection is disabled
+class MappedFile {
+    private:
+        const char* data_;
+        std::size_t size_;
+        void* mapping;
+        std::vector<char> buffer;
+
+        bool isUncompressed(const char* filename) {
+            struct archive* file = archive_read_new();
+            archive_read_support_filter_all(file);
+            archive_read_support_format_raw(file);
+            archive_read_support_format_empty(file);
+
+            if (archive_read_open_filename(file, filename, 16384) != ARCHIVE_OK) {
+                std::string error(archive_error_string(file));
+                archive_read_free(file);
+                throw ParserException(error + std::string(" Error opening file: ") + std::string(filename));
+            }
+
+            struct archive_entry* entry;
+            int r = archive_read_next_header(file, &entry);
+
+            bool uncompressed = r != ARCHIVE_OK || archive_filter_code(file, 0) == ARCHIVE_FILTER_NONE;
+            archive_read_free(file);
+
+            return uncompressed;
+        }
+
+        void mapFile(const char* filename) {
+            int fd = open(filename, O_RDONLY);
+            if (fd < 0) {
+                throw ParserException(std::string("Error opening file: ") + std::string(filename));
+            }
+
+            struct stat fileStats;
+            if (fstat(fd, &fileStats) != 0) {
+                close(fd);
+                throw ParserException(std::string("Error reading file size: ") + std::string(filename));
+            }
+
+            size_ = fileStats.st_size;
+
+            if (size_ > 0) {
+                mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapping == MAP_FAILED) {
+                    close(fd);
+                    throw ParserException(std::string("Error mapping file: ") + std::string(filename));
+                }
+                madvise(mapping, size_, MADV_SEQUENTIAL);
+                data_ = static_cast<const char*>(mapping);
+            }
+
+            close(fd);
+        }
+
+        void decompressFile(const char* filename) {
+            struct archive* file = archive_read_new();
+            archive_read_support_filter_all(file);
+            archive_read_support_format_raw(file);
+
+            struct archive_entry* entry;
+            if (archive_read_open_filename(file, filename, 16384) != ARCHIVE_OK || archive_read_next_header(file, &entry) != ARCHIVE_OK) {
+                archive_read_free(file);
+                throw ParserException(std::string("Error reading file: ") + std::string(filename));
+            }
+
+            char chunk[65536];
+            la_ssize_t readBytes;
+            while ((readBytes = archive_read_data(file, chunk, sizeof(chunk))) > 0) {
+                buffer.insert(buffer.end(), chunk, chunk + readBytes);
+            }
+            archive_read_free(file);
+
+            if (readBytes < 0) {
+                throw ParserException(std::string("Error decompressing file: ") + std::string(filename));
+            }
+
+            data_ = buffer.data();
+            size_ = buffer.size();
+        }
+
+    public:
+        explicit MappedFile(const char* filename, bool detectCompression = true) : data_(nullptr), size_(0), mapping(nullptr) {
+            if (!detectCompression || isUncompressed(filename)) {
+                mapFile(filename);
+            } else {
+                decompressFile(filename);
+            }
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        ~MappedFile() {
+            if (mapping != nullptr) {
+                munmap(mapping, size_);
+            }
+        }
+
+        const char* data() const {
+            return data_;
+        }
+
+        std::size_t size() const {
+            return size_;
+        }
+};
+
+#endif
@@ -0,0 +1,169 @@
+#ifndef SRC_PARSER_PARSEDFORMULACACHE_H_
+#define SRC_PARSER_PARSEDFORMULACACHE_H_
+
+#include <vector>
+#include <map>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "Parser.h"
+#include "SATTypes.h"
+#include "MappedFile.h"
+#include "Hash.h"
+#include "CompressionHeader.h"
+#include "FormulaCache.h"
+#include "Preprocessing.h"
+#include "Equivalences.h"
+#include "Renumbering.h"
+#include "Propagation.h"
+
+struct ParsedFormula {
+    std::vector<Cl> clauses;
+    unsigned int nrVariables;
+    uint64_t fingerprint;
+    //literals that are assigned by the unit propagation before the first decision, in the order of the propagation
+    std::vector<Lit> rootLiterals;
+    //variables that are replaced by an equivalent literal, their values are restored from the values of the literals
+    std::vector<Equivalences::Substitution> substitutions;
+    //original id of every variable if the formula was renumbered, the model is mapped with it at the input and the output
+    std::vector<unsigned int> originalIds;
+    Preprocessing::Statistics preprocessing;
+};
+
+//keeps the recently parsed formulas in memory so that every formula of a batch is only parsed once.
+//Files with the same content are found by the hash of the file, formulas that only differ in their formatting share the same parsed clauses
+class ParsedFormulaCache {
+    private:
+        std::size_t capacity;
+        std::map<std::string, uint64_t> contentHashes;
+        //formula files that were read from an archive, they are found by the same path as files on disk
+        std::map<std::string, std::string> inMemoryFiles;
+        std::map<uint64_t, std::shared_ptr<const ParsedFormula>> byContentHash;
+        std::map<uint64_t, std::weak_ptr<const ParsedFormula>> byFingerprint;
+        std::list<uint64_t> recentlyUsed;
+
+        void touch(uint64_t contentHash) {
+            recentlyUsed.remove(contentHash);
+            recentlyUsed.push_front(contentHash);
+
+            while (recentlyUsed.size() > capacity) {
+                byContentHash.erase(recentlyUsed.back());
+                recentlyUsed.pop_back();
+            }
+        }
+
+    public:
+        explicit ParsedFormulaCache(std::size_t capacity = 16) : capacity(capacity) {}
+
+        //registers the content of a formula file that does not exist on disk
+        void addFile(const std::string& formulaFile, std::string content) {
+            contentHashes.erase(formulaFile);
+            inMemoryFiles[formulaFile] = std::move(content);
+        }
+
+        //hash of the file content, the formula files are expected to stay unchanged during a run
+        uint64_t contentHash(const char* formulaFile) {
+            auto it = contentHashes.find(formulaFile);
+            if (it != contentHashes.end()) {
+                return it->second;
+            }
+
+            uint64_t hash;
+            auto fileIt = inMemoryFiles.find(formulaFile);
+
+            if (fileIt != inMemoryFiles.end()) {
+                hash = Hash::xxh64(fileIt->second.data(), fileIt->second.size());
+            } else {
+                MappedFile file(formulaFile, false);
+                hash = Hash::xxh64(file.data(), file.size());
+            }
+            contentHashes[formulaFile] = hash;
+
+            return hash;
+        }
+
+        //returns the formula prepared with the modes of the flags of the compression header. Every variant is prepared once
+        //from the parsed formula and cached like the parsed formula itself, the flags that do not change the clauses are ignored
+        std::shared_ptr<const ParsedFormula> get(const char* formulaFile, unsigned int parserThreads, uint32_t flags) {
+            flags &= CompressionHeader::FORMULA_FLAGS;
+
+            if (flags == 0) {
+                return get(formulaFile, parserThreads);
+            }
+
+            uint64_t hash = FormulaCache::variantHash(contentHash(formulaFile), flags);
+
+            auto it = byContentHash.find(hash);
+            if (it != byContentHash.end()) {
+                touch(hash);
+                return it->second;
+            }
+
+            std::shared_ptr<ParsedFormula> formula = std::make_shared<ParsedFormula>(*get(formulaFile, parserThreads));
+
+            if (flags & CompressionHeader::PREPROCESSED) {
+                formula->preprocessing = Preprocessing::apply(formula->clauses);
+            }
+
+            //the substitution runs before the root propagation, so the unit clauses that it creates are propagated as well
+            if (flags & CompressionHeader::EQUIVALENT_LITERALS) {
+                formula->substitutions = Equivalences::substitute(formula->clauses, formula->nrVariables);
+            }
+
+            if (flags & CompressionHeader::ROOT_PROPAGATION) {
+                formula->rootLiterals = Propagation::propagateRoot(formula->clauses, formula->nrVariables);
+            }
+
+            //the renumbering runs last, so it also renumbers the assigned and substituted variables
+            if (flags & CompressionHeader::RENUMBERED) {
+                formula->originalIds = Renumbering::apply(formula->clauses, formula->nrVariables, formula->rootLiterals, formula->substitutions);
+            }
+
+            formula->fingerprint = Parser::formulaFingerprint(formula->clauses, formula->nrVariables, formula->rootLiterals, formula->substitutions, formula->originalIds);
+
+            byContentHash[hash] = formula;
+            touch(hash);
+
+            return formula;
+        }
+
+        std::shared_ptr<const ParsedFormula> get(const char* formulaFile, unsigned int parserThreads) {
+            uint64_t hash = contentHash(formulaFile);
+
+            auto it = byContentHash.find(hash);
+            if (it != byContentHash.end()) {
+                touch(hash);
+                return it->second;
+            }
+
+            Parser parser(formulaFile, nullptr);
+
+            auto fileIt = inMemoryFiles.find(formulaFile);
+            if (fileIt != inMemoryFiles.end()) {
+                parser.setFormulaContent(&fileIt->second);
+            }
+
+            std::shared_ptr<ParsedFormula> formula = std::make_shared<ParsedFormula>();
+            formula->clauses = parserThreads > 1 ? parser.readClausesParallel(parserThreads) : parser.readClauses();
+            formula->nrVariables = parser.readVariables().size();
+            formula->fingerprint = Parser::formulaFingerprint(formula->clauses, formula->nrVariables);
+
+            std::shared_ptr<const ParsedFormula> result = formula;
+
+            //share the clauses with an identical formula that is still in memory
+            auto fingerprintIt = byFingerprint.find(formula->fingerprint);
+            if (fingerprintIt != byFingerprint.end() && !fingerprintIt->second.expired()) {
+                result = fingerprintIt->second.lock();
+            } else {
+                byFingerprint[formula->fingerprint] = result;
+            }
+
+            byContentHash[hash] = result;
+            touch(hash);
+
+            return result;
+        }
+};
+
+#endif
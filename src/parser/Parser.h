@@ -2,116 +2,525 @@
 #define SRC_PARSER_PARSER_H_
 
 #include <vector>
+#include <deque>
 #include <algorithm>
 #include <map>
 #include <fstream>
 #include <sstream>
 #include <filesystem>
+#include <limits>
+#include <cstring>
+#include <stdexcept>
 
 namespace fs = std::filesystem;
 
 #include "StreamBuffer.h"
+#include "MappedFile.h"
 #include "SATTypes.h"
 #include "StringCompression.h"
+#include "CompressionHeader.h"
+#include "Portfolio.h"
+#include "Hash.h"
+#include "Parallel.h"
+#include "Equivalences.h"
 
 class Parser
 {
 private:
     const char *formulaFilename;
     const char *modelFilename;
+    //contents of the files if they were already read into memory, e.g. from an archive
+    const std::string *formulaContent = nullptr;
+    const std::string *modelContent = nullptr;
+
+    //clauses of one chunk of the formula file, the last clause is still open if its terminating 0 lies in a later chunk
+    struct ClauseChunk {
+        std::vector<Cl> clauses;
+        bool lastOpen = false;
+    };
+
+    ClauseChunk parseClauseChunk(const char* begin, const char* end) {
+        ClauseChunk chunk;
+        Cl clause;
+        bool lineStart = true;
+        const char* pos = begin;
+
+        while (pos < end) {
+            char c = *pos;
+
+            if (c == '\n' || c == '\r') {
+                lineStart = true;
+                pos++;
+                continue;
+            } else if (isspace(c)) {
+                pos++;
+                continue;
+            }
+
+            //skip comments and the header line
+            if (lineStart && (c == 'c' || c == 'p')) {
+                while (pos < end && *pos != '\n' && *pos != '\r') {
+                    pos++;
+                }
+                continue;
+            }
+
+            lineStart = false;
+
+            bool negative = false;
+            if (c == '-') {
+                negative = true;
+                pos++;
+            } else if (c == '+') {
+                pos++;
+            }
+
+            if (pos == end || !isdigit(*pos)) {
+                throw ParserException(std::string(formulaFilename) + ": unexpected character: " + c);
+            }
+
+            uint64_t number = 0;
+            while (pos < end && isdigit(*pos)) {
+                number = number * 10 + (*pos - '0');
+                if (number > std::numeric_limits<int32_t>::max()) {
+                    throw ParserException(std::string(formulaFilename) + ": number out of int32 range");
+                }
+                pos++;
+            }
+
+            if (number == 0) {
+                chunk.clauses.push_back(std::move(clause));
+                clause = Cl();
+            } else {
+                clause.addLiteral(Lit(number, negative));
+            }
+        }
+
+        if (!clause.literals.empty()) {
+            chunk.clauses.push_back(std::move(clause));
+            chunk.lastOpen = true;
+        }
+
+        return chunk;
+    }
+
+    //splits the data at line boundaries and tokenizes the chunks with multiple threads
+    std::vector<Cl> parseClauses(const char* data, std::size_t size, unsigned int nrThreads) {
+        if (nrThreads < 1) {
+            nrThreads = 1;
+        }
+
+        //every chunk is moved to the beginning of the next line, the end of a chunk is moved the same way as the beginning of the next chunk
+        auto lineStart = [&](std::size_t position) {
+            while (position > 0 && position < size && data[position - 1] != '\n') {
+                position++;
+            }
+            return position;
+        };
+
+        std::vector<ClauseChunk> chunks(nrThreads);
+
+        Parallel::forChunks(size, nrThreads, [&](unsigned int chunk, std::size_t begin, std::size_t end) {
+            chunks[chunk] = parseClauseChunk(data + lineStart(begin), data + lineStart(end));
+        });
+
+        std::size_t nrClauses = 0;
+        for (ClauseChunk& chunk: chunks) {
+            nrClauses += chunk.clauses.size();
+        }
+
+        std::vector<Cl> formula;
+        formula.reserve(nrClauses);
+        bool open = false;
+
+        for (ClauseChunk& chunk: chunks) {
+            if (chunk.clauses.empty()) {
+                continue;
+            }
+
+            auto it = chunk.clauses.begin();
+
+            //continue the open clause of the previous chunk
+            if (open) {
+                for (Lit lit: it->literals) {
+                    formula.back().addLiteral(lit);
+                }
+                it++;
+            }
+
+            std::move(it, chunk.clauses.end(), std::back_inserter(formula));
+            open = chunk.lastOpen;
+        }
+
+        return formula;
+    }
+
+    //parses a model in the format of the solver output into a dense representation
+    Model parseModel(const char* data, std::size_t size, unsigned int nrVariables) {
+        const char* pos = data;
+        const char* end = data + size;
+        Model model(nrVariables);
+
+        while (pos < end) {
+            char c = *pos;
+
+            if (isspace(c)) {
+                pos++;
+                continue;
+            } else if (c == 'c') {
+                while (pos < end && *pos != '\n' && *pos != '\r') {
+                    pos++;
+                }
+                continue;
+            } else if (c != '-' && !isdigit(c)) {
+                pos++;
+                continue;
+            }
+
+            bool negative = false;
+            if (c == '-') {
+                negative = true;
+                pos++;
+            }
+
+            if (pos == end || !isdigit(*pos)) {
+                throw ParserException(std::string(modelFilename) + ": unexpected character: " + c);
+            }
+
+            uint64_t number = 0;
+            while (pos < end && isdigit(*pos)) {
+                number = number * 10 + (*pos - '0');
+                if (number > std::numeric_limits<int32_t>::max()) {
+                    throw ParserException(std::string(modelFilename) + ": number out of int32 range");
+                }
+                pos++;
+            }
+
+            if (number == 0) {
+                break;
+            }
+
+            ModelVar newModelVar = ModelVar(negative ? -static_cast<int>(number) : static_cast<int>(number));
+
+            //check if variable is already contained in the model to prevent multiple assignents for the same variable
+            if (!model.assign(newModelVar)) {
+                throw std::runtime_error("A variable gets assigned multiple times in the model: " + std::to_string(newModelVar.id));
+            }
+        }
+
+        return model;
+    }
+
+    //reads the number of variables from the "p cnf" line, returns 0 if the line is missing
+    static int parseNumberOfVariables(const char* data, std::size_t size) {
+        const char* pos = data;
+        const char* end = data + size;
+        const char* header = "p cnf ";
+
+        while (pos < end) {
+            if (isspace(*pos)) {
+                pos++;
+                continue;
+            }
+
+            if (*pos == 'p') {
+                std::size_t headerLength = strlen(header);
+                if (static_cast<std::size_t>(end - pos) < headerLength || std::strncmp(pos, header, headerLength) != 0) {
+                    return 0;
+                }
+                pos += headerLength;
+
+                while (pos < end && (*pos == ' ' || *pos == '\t')) {
+                    pos++;
+                }
+
+                int nrVariables = 0;
+                while (pos < end && isdigit(*pos)) {
+                    nrVariables = nrVariables * 10 + (*pos - '0');
+                    pos++;
+                }
+                return nrVariables;
+            }
+
+            //skip comments and everything else that precedes the header line
+            while (pos < end && *pos != '\n' && *pos != '\r') {
+                pos++;
+            }
+        }
+
+        return 0;
+    }
+
 public:
     explicit Parser(const char *formulaFilename, const char *modelFilename) : formulaFilename(formulaFilename), modelFilename(modelFilename) {}
 
+    void setFormulaContent(const std::string* content) {
+        formulaContent = content;
+    }
+
+    void setModelContent(const std::string* content) {
+        modelContent = content;
+    }
+
+    //reads the clauses sequentially. Compressed formulas are decompressed while they are read, so only the buffer of the stream is in memory.
+    //Comment lines and the header line are skipped wherever they start, also between the literals of a clause, like in parseClauseChunk()
     std::vector<Cl> readClauses() {
+        if (formulaContent != nullptr) {
+            return parseClauses(formulaContent->data(), formulaContent->size(), 1);
+        }
+
         StreamBuffer reader(formulaFilename);
         std::vector<Cl> formula;
+        Cl clause;
+        bool lineStart = true;
 
-        while (reader.skipWhitespace()) {
-            Cl clause;
+        while (!reader.eof()) {
+            char c = *reader;
 
-            if (*reader == 'p' || *reader == 'c') {
+            if (c == '\n' || c == '\r') {
+                lineStart = true;
+                reader.skip();
+                continue;
+            } else if (isspace(c)) {
+                reader.skip();
+                continue;
+            }
+
+            //skip comments and the header line, the reader stops at the beginning of the next line that is not empty
+            if (lineStart && (c == 'c' || c == 'p')) {
                 if (!reader.skipLine()) {
                     break;
                 }
+                continue;
             }
 
-            int literal;
-            while(reader.readInteger(&literal) && literal != 0) {
-                Lit newLit = Lit(abs(literal), (literal < 0));
+            lineStart = false;
 
-                //check if the inverted literal is contained in the clause in which case the clause is a tautology and can be ignored
-                /*
-                if (clause.containsLiteral(~newLit)) {
-                    continue;
-                }
-                */
+            int literal;
+            reader.readInteger(&literal);
 
-                clause.addLiteral(newLit);
+            if (literal == 0) {
+                formula.push_back(std::move(clause));
+                clause = Cl();
+            } else {
+                clause.addLiteral(Lit(abs(literal), (literal < 0)));
             }
-            formula.push_back(clause);
+        }
+
+        if (!clause.literals.empty()) {
+            formula.push_back(std::move(clause));
         }
 
         return formula;
     }
 
-    std::map<unsigned int, ModelVar> readModel() {
-        StreamBuffer reader(modelFilename);
-        std::map<unsigned int, ModelVar> model;
+    //parses the clauses with multiple threads. The file is split at line boundaries and the chunks are tokenized
+    //independently, the clauses are then concatenated in file order so that the result is identical to readClauses()
+    std::vector<Cl> readClausesParallel(unsigned int nrThreads) {
+        if (formulaContent != nullptr) {
+            return parseClauses(formulaContent->data(), formulaContent->size(), nrThreads);
+        }
 
-        while (reader.skipWhitespace()) {
-            if (*reader == 'c') {
-                if (!reader.skipLine()) {
-                    break;
-                } else {
-                    continue;
+        MappedFile file(formulaFilename);
+        return parseClauses(file.data(), file.size(), nrThreads);
+    }
+
+    //hash of the normalized formula. Only the number of variables and the literals of the clauses in their order are hashed,
+    //so formatting and comments are ignored but every change that influences the compression results in a different value
+    //The literals that are assigned before the first decision are hashed after the clauses, without them the value is the same as for a formula without root assignments.
+    //The same holds for the substituted variables. The hash is a separate pass over the parsed clauses and not part of the parsing, as the chunks of the
+    //parallel parser are hashed in file order only after they are joined and the prepared formulas are hashed after their clauses were changed
+    static uint64_t formulaFingerprint(const std::vector<Cl>& clauses, unsigned int nrVariables, const std::vector<Lit>& rootLiterals = {},
+                                       const std::vector<Equivalences::Substitution>& substitutions = {}, const std::vector<unsigned int>& originalIds = {}) {
+        Hash::XXH64 hasher;
+        hasher.updateValue<uint32_t>(nrVariables);
+
+        std::vector<int32_t> buffer;
+
+        for (const Cl& clause: clauses) {
+            buffer.clear();
+            for (Lit lit: clause.literals) {
+                buffer.push_back(lit.negative ? -static_cast<int32_t>(lit.id) : static_cast<int32_t>(lit.id));
+            }
+            buffer.push_back(0);
+
+            hasher.update(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(int32_t));
+        }
+
+        if (!rootLiterals.empty()) {
+            hasher.update("root", 4);
+
+            for (Lit lit: rootLiterals) {
+                hasher.updateValue<int32_t>(lit.negative ? -static_cast<int32_t>(lit.id) : static_cast<int32_t>(lit.id));
+            }
+        }
+
+        if (!substitutions.empty()) {
+            hasher.update("equivalences", 12);
+
+            for (const Equivalences::Substitution& substitution: substitutions) {
+                Lit lit = substitution.literal;
+                hasher.updateValue<uint32_t>(substitution.variable);
+                hasher.updateValue<int32_t>(lit.negative ? -static_cast<int32_t>(lit.id) : static_cast<int32_t>(lit.id));
+            }
+        }
+
+        if (!originalIds.empty()) {
+            hasher.update("renumbering", 11);
+            hasher.update(reinterpret_cast<const char*>(originalIds.data()), originalIds.size() * sizeof(unsigned int));
+        }
+
+        return hasher.digest();
+    }
+
+    //fills the occurence lists of the variables, every list is in the order of the clauses for every number of threads.
+    //With multiple threads the clauses are split into chunks and every chunk thread sorts its literals into one bucket per range of variables.
+    //Every range thread then reads its buckets in the order of the chunks, so every literal is only visited once by each pass.
+    //The lists are counted first, so they are allocated once with their exact size
+    static void buildOccurenceLists(std::vector<Cl>& clauses, std::vector<Var>& variables, unsigned int nrThreads) {
+        auto checkVariable = [&](Lit lit) {
+            if (lit.id - 1 >= variables.size()) {
+                throw std::out_of_range("The formula contains the variable " + std::to_string(lit.id) + " but only has " + std::to_string(variables.size()) + " variables.");
+            }
+        };
+
+        auto reserve = [&](std::size_t begin, const std::vector<std::size_t>& posCounts, const std::vector<std::size_t>& negCounts) {
+            for (std::size_t i = 0; i < posCounts.size(); i++) {
+                variables[begin + i].posOccList.reserve(variables[begin + i].posOccList.size() + posCounts[i]);
+                variables[begin + i].negOccList.reserve(variables[begin + i].negOccList.size() + negCounts[i]);
+            }
+        };
+
+        auto add = [&](Cl* clause, Lit lit) {
+            if (lit.negative) {
+                variables[lit.id - 1].addNegClause(clause);
+            } else {
+                variables[lit.id - 1].addPosClause(clause);
+            }
+        };
+
+        if (nrThreads <= 1) {
+            std::vector<std::size_t> posCounts(variables.size(), 0);
+            std::vector<std::size_t> negCounts(variables.size(), 0);
+
+            for (const Cl& clause: clauses) {
+                for (Lit lit: clause.literals) {
+                    checkVariable(lit);
+                    (lit.negative ? negCounts : posCounts)[lit.id - 1] += 1;
+                }
+            }
+
+            reserve(0, posCounts, negCounts);
+
+            for (Cl& clause: clauses) {
+                for (Lit lit: clause.literals) {
+                    add(&clause, lit);
                 }
-            } else if (!(*reader == '-') && !std::isdigit(*reader)) {
-                reader.skip();
-                continue;
             }
 
-            int assignment;
+            return;
+        }
 
-            reader.readInteger(&assignment);
+        struct Occurence {
+            Cl* clause;
+            Lit lit;
+        };
 
-            if (assignment != 0) {
-                ModelVar newModelVar = ModelVar(assignment);
+        //indexed by the chunk of the clauses and the range of the variables
+        std::vector<std::vector<std::vector<Occurence>>> buckets(nrThreads, std::vector<std::vector<Occurence>>(nrThreads));
 
-                //check if variable is already contained in the vector to prevent multiple assignents for the same variable
-                if (model.count(newModelVar.id)) {
-                    throw std::runtime_error("A variable gets assigned multiple times in the model: " + std::to_string(newModelVar.id));
+        Parallel::forChunks(clauses.size(), nrThreads, [&](unsigned int chunk, std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                for (Lit lit: clauses[i].literals) {
+                    checkVariable(lit);
+                    buckets[chunk][Parallel::chunkOf(variables.size(), nrThreads, lit.id - 1)].push_back(Occurence{&clauses[i], lit});
                 }
+            }
+        });
 
-                model.insert(std::pair<unsigned int, ModelVar>(newModelVar.id, newModelVar));
-            } else {
-                break;
+        Parallel::forChunks(variables.size(), nrThreads, [&](unsigned int range, std::size_t begin, std::size_t end) {
+            std::vector<std::size_t> posCounts(end - begin, 0);
+            std::vector<std::size_t> negCounts(end - begin, 0);
+
+            for (unsigned int chunk = 0; chunk < nrThreads; chunk++) {
+                for (const Occurence& occurence: buckets[chunk][range]) {
+                    (occurence.lit.negative ? negCounts : posCounts)[occurence.lit.id - 1 - begin] += 1;
+                }
+            }
+
+            reserve(begin, posCounts, negCounts);
+
+            for (unsigned int chunk = 0; chunk < nrThreads; chunk++) {
+                for (const Occurence& occurence: buckets[chunk][range]) {
+                    add(occurence.clause, occurence.lit);
+                }
+
+                std::vector<Occurence>().swap(buckets[chunk][range]);
+            }
+        });
+    }
+
+    //fills the implication lists of the variables from their occurence lists. A binary clause implies its other literal,
+    //a clause that contains the same literal twice implies this literal
+    static void buildImplicationLists(std::vector<Var>& variables, unsigned int nrThreads) {
+        auto build = [](const std::vector<Cl*>& occList, Lit lit, std::vector<Implication>& implications) {
+            implications.clear();
+            implications.reserve(occList.size());
+
+            for (Cl* clause: occList) {
+                if (clause->literals.size() == 2) {
+                    implications.push_back(Implication(clause->literals[0] == lit ? clause->literals[1] : clause->literals[0]));
+                } else {
+                    implications.push_back(Implication(clause));
+                }
             }
+        };
+
+        Parallel::forChunks(variables.size(), nrThreads, [&](unsigned int /*chunk*/, std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                Var& var = variables[i];
+                build(var.posOccList, Lit(var.id, false), var.posImplications);
+                build(var.negOccList, Lit(var.id, true), var.negImplications);
+            }
+        });
+    }
+
+    //reads the model into a dense representation that is sized for the given number of variables.
+    //Comment lines are skipped as well as all other characters that do not belong to a number
+    Model readModel(unsigned int nrVariables) {
+        if (modelContent != nullptr) {
+            return parseModel(modelContent->data(), modelContent->size(), nrVariables);
         }
 
-        return model;
-        
+        MappedFile file(modelFilename);
+        return parseModel(file.data(), file.size(), nrVariables);
     }
 
     std::vector<Var> readVariables() {
-        StreamBuffer reader(formulaFilename);
         std::vector<Var> variables;
         int nrVariables = 0;
 
-        while (reader.skipWhitespace()) {
-            if (*reader == 'c') {
-                if (!reader.skipLine()) {
-                    break;
+        if (formulaContent != nullptr) {
+            nrVariables = parseNumberOfVariables(formulaContent->data(), formulaContent->size());
+        } else {
+            StreamBuffer reader(formulaFilename);
+
+            while (reader.skipWhitespace()) {
+                if (*reader == 'c') {
+                    if (!reader.skipLine()) {
+                        break;
+                    }
                 }
-            }
 
-            if (*reader == 'p') {
-                if (!reader.skipString("p cnf ")) {
+                if (*reader == 'p') {
+                    if (!reader.skipString("p cnf ")) {
+                        break;
+                    }
+
+                    //read the number of variables
+                    reader.readInteger(&nrVariables);
                     break;
                 }
-
-                //read the number of variables
-                reader.readInteger(&nrVariables);
-                break;
             }
         }
 
@@ -123,16 +532,56 @@ public:
         return variables;
     }
 
-    std::deque<uint64_t> readCompressedFile(std::string genericCompression, unsigned int golombRiceParameter, unsigned int variablesSize) {
-        std::deque<uint64_t> distances;
+    //reads only the header of the compressed model, e.g. to know the modes of the compression before the formula is prepared
+    CompressionHeader readCompressedHeader() {
+        if (modelContent != nullptr) {
+            return CompressionHeader::parse(*modelContent);
+        }
+
+        std::ifstream compressedFile(modelFilename, std::ios::binary);
+        std::string serializedHeader(CompressionHeader::FLAGS_SIZE, '\0');
+        compressedFile.read(serializedHeader.data(), serializedHeader.size());
+        serializedHeader.resize(compressedFile.gcount());
+
+        return CompressionHeader::parse(serializedHeader);
+    }
+
+    std::deque<uint64_t> readCompressedFile(std::string genericCompression, unsigned int golombRiceParameter, unsigned int variablesSize, CompressionHeader& header) {
+        return decodeDistances(readCompressedPayload(header), genericCompression, golombRiceParameter, variablesSize * 3);
+    }
 
+    //reads the compressed file and returns the data behind the header
+    std::string readCompressedPayload(CompressionHeader& header) {
         //read the whole file into a string
-        std::ifstream compressedFile(modelFilename);
-        std::stringstream buffer;
-        buffer << compressedFile.rdbuf();
-        std::string compressedString = buffer.str();
+        std::string compressedString;
+
+        if (modelContent != nullptr) {
+            compressedString = *modelContent;
+        } else {
+            std::ifstream compressedFile(modelFilename);
+            std::stringstream buffer;
+            buffer << compressedFile.rdbuf();
+            compressedString = buffer.str();
+        }
 
-        //decompress the string and write the contents to a temporary file
+        //split the header from the compressed data
+        header = CompressionHeader::parse(compressedString);
+        compressedString.erase(0, header.size());
+
+        return compressedString;
+    }
+
+    //decompresses the encoding of the decisions. The decompressed size is only needed by lz4, it must not be smaller than the encoding.
+    //The encoding of the generic compression auto starts with the id of its codec
+    std::deque<uint64_t> decodeDistances(const std::string& compressedString, const std::string& genericCompression, unsigned int golombRiceParameter, std::size_t decompressedSize) {
+        if (genericCompression == "auto") {
+            const std::string& codec = Portfolio::parseCodec(compressedString);
+            return decodeDistances(compressedString.substr(1), codec, golombRiceParameter, decompressedSize);
+        }
+
+        std::deque<uint64_t> distances;
+
+        //decompress the string
         std::string decompressedString;
 
         if (genericCompression == "golrice") {
@@ -140,34 +589,34 @@ public:
         } else if (genericCompression == "zip") {
             decompressedString = StringCompression::decompressString(compressedString);
         } else if (genericCompression == "lz4") {
-            decompressedString = StringCompression::lz4Decompression(compressedString, variablesSize * 3);
+            decompressedString = StringCompression::lz4Decompression(compressedString, decompressedSize);
         } else {
             throw std::runtime_error("Unknown compression algorithm: " + genericCompression);
         }
 
-        if (!decompressedString.empty()) {
-            std::string modelFilenameString(modelFilename);
-            std::string temporaryFileName = modelFilenameString.substr(0, modelFilenameString.size() - 4) + "_tmp.txt";
-
-            //std::cout << "temporaryFileName: " << temporaryFileName << std::endl;
-            //std::cout << "decompressed string: " << decompressedString << std::endl;
+        //read the whitespace separated distances
+        const char* pos = decompressedString.data();
+        const char* end = pos + decompressedString.size();
 
-            std::ofstream temporaryFileStream(temporaryFileName.c_str());
-            temporaryFileStream << decompressedString;
-            temporaryFileStream.close();
+        while (pos < end) {
+            if (isspace(*pos)) {
+                pos++;
+                continue;
+            }
 
-            StreamBuffer reader(temporaryFileName.c_str());
-            uint64_t currentDistance;
+            if (!isdigit(*pos)) {
+                throw ParserException(std::string(modelFilename) + ": unexpected character: " + *pos);
+            }
 
-            while (reader.readUInt64(&currentDistance)) {
-                distances.push_back(currentDistance);
+            uint64_t currentDistance = 0;
+            while (pos < end && isdigit(*pos)) {
+                currentDistance = currentDistance * 10 + (*pos - '0');
+                pos++;
             }
 
-            //delete the temporary file
-            fs::path temoraryPath(temporaryFileName.c_str());
-            fs::remove(temoraryPath);
+            distances.push_back(currentDistance);
         }
-        
+
         return distances;
     }
 };
@@ -0,0 +1,115 @@
+#ifndef SRC_PARSER_PREPROCESSING_H_
+#define SRC_PARSER_PREPROCESSING_H_
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+#include "SATTypes.h"
+#include "Hash.h"
+
+//simplifications of the formula that do not change its models. The compression and the decompression must apply
+//exactly the same steps, so the result only depends on the clauses and their order
+namespace Preprocessing {
+
+    struct Statistics {
+        std::size_t duplicateLiterals = 0;
+        std::size_t tautologies = 0;
+        std::size_t duplicateClauses = 0;
+    };
+
+    inline uint64_t clauseHash(const Cl& clause) {
+        Hash::XXH64 hasher;
+        for (Lit lit: clause.literals) {
+            hasher.updateValue<uint32_t>(lit.id);
+            hasher.updateValue<uint8_t>(lit.negative);
+        }
+        return hasher.digest();
+    }
+
+    //sorts the literals of every clause, removes duplicate literals, tautologies and duplicate clauses.
+    //The first occurence of a duplicate clause is kept, so the remaining clauses stay in their original order
+    inline Statistics apply(std::vector<Cl>& clauses) {
+        Statistics statistics;
+        std::vector<Cl> result;
+        result.reserve(clauses.size());
+
+        for (Cl& clause: clauses) {
+            std::vector<Lit>& literals = clause.literals;
+
+            std::sort(literals.begin(), literals.end(), [](Lit x, Lit y) {
+                return x.id != y.id ? x.id < y.id : x.negative < y.negative;
+            });
+
+            Cl simplified;
+            bool tautology = false;
+
+            for (std::size_t i = 0; i < literals.size(); i++) {
+                if (i > 0 && literals[i] == literals[i - 1]) {
+                    statistics.duplicateLiterals += 1;
+                    continue;
+                }
+
+                //both polarities of the same variable are next to each other after sorting
+                if (i > 0 && literals[i].id == literals[i - 1].id) {
+                    tautology = true;
+                    break;
+                }
+
+                simplified.addLiteral(literals[i]);
+            }
+
+            if (tautology) {
+                statistics.tautologies += 1;
+                continue;
+            }
+
+            result.push_back(std::move(simplified));
+        }
+
+        //find duplicate clauses by sorting the clauses by their hash, clauses with the same hash are compared literal by literal
+        std::vector<std::pair<uint64_t, std::size_t>> hashes;
+        hashes.reserve(result.size());
+
+        for (std::size_t i = 0; i < result.size(); i++) {
+            hashes.emplace_back(clauseHash(result[i]), i);
+        }
+
+        std::sort(hashes.begin(), hashes.end());
+
+        std::vector<bool> duplicate(result.size(), false);
+
+        for (std::size_t begin = 0; begin < hashes.size();) {
+            std::size_t end = begin + 1;
+            while (end < hashes.size() && hashes[end].first == hashes[begin].first) {
+                end++;
+            }
+
+            //the indices are sorted within a group, so the first occurence of every clause is kept
+            for (std::size_t i = begin; i < end; i++) {
+                for (std::size_t j = begin; j < i && !duplicate[hashes[i].second]; j++) {
+                    if (!duplicate[hashes[j].second] && result[hashes[j].second].literals == result[hashes[i].second].literals) {
+                        duplicate[hashes[i].second] = true;
+                    }
+                }
+            }
+
+            begin = end;
+        }
+
+        clauses.clear();
+        clauses.reserve(result.size());
+
+        for (std::size_t i = 0; i < result.size(); i++) {
+            if (duplicate[i]) {
+                statistics.duplicateClauses += 1;
+            } else {
+                clauses.push_back(std::move(result[i]));
+            }
+        }
+
+        return statistics;
+    }
+}
+
+#endif
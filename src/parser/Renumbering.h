@@ -0,0 +1,199 @@
+#ifndef SRC_PARSER_RENUMBERING_H_
+#define SRC_PARSER_RENUMBERING_H_
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+#include "SATTypes.h"
+#include "Equivalences.h"
+
+//renumbering of the variables and clauses in a Cuthill-McKee order of the variable interaction graph. Variables that share
+//clauses get neighboring ids and the clauses are sorted by their smallest variable, so the propagation reads values,
+//occurence lists and clauses that are close to each other. The order only depends on the clauses, so the compression and
+//the decompression renumber the formula identically. The model is mapped to the new ids when it is read and back when it is written
+namespace Renumbering {
+
+    //returns the original id of every new id, the variable at position i has the new id i + 1
+    inline std::vector<unsigned int> order(const std::vector<Cl>& clauses, unsigned int nrVariables) {
+        //the clauses of every variable, a variable that occurs twice in a clause is listed twice
+        std::vector<std::size_t> offsets(nrVariables + 1, 0);
+        for (const Cl& clause: clauses) {
+            for (Lit lit: clause.literals) {
+                offsets.at(lit.id) += 1;
+            }
+        }
+
+        for (std::size_t i = 1; i < offsets.size(); i++) {
+            offsets[i] += offsets[i - 1];
+        }
+
+        std::vector<std::size_t> occurences(offsets.back());
+        std::vector<std::size_t> positions(offsets.begin(), offsets.end() - 1);
+        for (std::size_t i = 0; i < clauses.size(); i++) {
+            for (Lit lit: clauses[i].literals) {
+                occurences[positions[lit.id - 1]++] = i;
+            }
+        }
+
+        //the number of occurences is used as the degree, the original id breaks ties
+        auto byDegree = [&](unsigned int x, unsigned int y) {
+            std::size_t degreeX = offsets[x] - offsets[x - 1];
+            std::size_t degreeY = offsets[y] - offsets[y - 1];
+            return degreeX != degreeY ? degreeX < degreeY : x < y;
+        };
+
+        //every connected part of the graph starts with its unvisited variable of the smallest degree
+        std::vector<unsigned int> starts;
+        for (unsigned int id = 1; id <= nrVariables; id++) {
+            if (offsets[id] != offsets[id - 1]) {
+                starts.push_back(id);
+            }
+        }
+        std::sort(starts.begin(), starts.end(), byDegree);
+
+        std::vector<bool> visitedVariables(nrVariables, false);
+        std::vector<bool> visitedClauses(clauses.size(), false);
+        std::vector<unsigned int> originalIds;
+        originalIds.reserve(nrVariables);
+        std::vector<unsigned int> neighbors;
+
+        for (unsigned int start: starts) {
+            if (visitedVariables[start - 1]) {
+                continue;
+            }
+
+            visitedVariables[start - 1] = true;
+            originalIds.push_back(start);
+
+            //the renumbered variables are the queue of the breadth first search
+            for (std::size_t head = originalIds.size() - 1; head < originalIds.size(); head++) {
+                unsigned int id = originalIds[head];
+                neighbors.clear();
+
+                //every clause is expanded once, so the search is linear in the number of literals
+                for (std::size_t j = offsets[id - 1]; j < offsets[id]; j++) {
+                    std::size_t clause = occurences[j];
+                    if (visitedClauses[clause]) {
+                        continue;
+                    }
+                    visitedClauses[clause] = true;
+
+                    for (Lit lit: clauses[clause].literals) {
+                        if (!visitedVariables[lit.id - 1]) {
+                            visitedVariables[lit.id - 1] = true;
+                            neighbors.push_back(lit.id);
+                        }
+                    }
+                }
+
+                std::sort(neighbors.begin(), neighbors.end(), byDegree);
+                originalIds.insert(originalIds.end(), neighbors.begin(), neighbors.end());
+            }
+        }
+
+        //the variables that do not occur in the clauses keep their order at the end
+        for (unsigned int id = 1; id <= nrVariables; id++) {
+            if (!visitedVariables[id - 1]) {
+                originalIds.push_back(id);
+            }
+        }
+
+        return originalIds;
+    }
+
+    //the new id of every original id
+    inline std::vector<unsigned int> newIds(const std::vector<unsigned int>& originalIds) {
+        std::vector<unsigned int> ids(originalIds.size());
+        for (unsigned int i = 0; i < originalIds.size(); i++) {
+            ids[originalIds[i] - 1] = i + 1;
+        }
+
+        return ids;
+    }
+
+    //renumbers the variables of the clauses, the assigned literals and the substitutions and sorts the clauses by their smallest new id.
+    //Returns the original id of every new id
+    inline std::vector<unsigned int> apply(std::vector<Cl>& clauses, unsigned int nrVariables, std::vector<Lit>& rootLiterals,
+                                           std::vector<Equivalences::Substitution>& substitutions) {
+        std::vector<unsigned int> originalIds = order(clauses, nrVariables);
+        std::vector<unsigned int> ids = newIds(originalIds);
+
+        auto renumber = [&](Lit lit) {
+            return Lit(ids[lit.id - 1], lit.negative);
+        };
+
+        //the clauses keep the order of their literals, an empty clause is moved to the end
+        std::vector<unsigned int> smallestIds(clauses.size(), std::numeric_limits<unsigned int>::max());
+        for (std::size_t i = 0; i < clauses.size(); i++) {
+            for (Lit& lit: clauses[i].literals) {
+                lit = renumber(lit);
+                smallestIds[i] = std::min(smallestIds[i], lit.id);
+            }
+        }
+
+        std::vector<std::size_t> clauseOrder(clauses.size());
+        for (std::size_t i = 0; i < clauseOrder.size(); i++) {
+            clauseOrder[i] = i;
+        }
+        std::stable_sort(clauseOrder.begin(), clauseOrder.end(), [&](std::size_t x, std::size_t y) {
+            return smallestIds[x] < smallestIds[y];
+        });
+
+        std::vector<Cl> renumbered;
+        renumbered.reserve(clauses.size());
+        for (std::size_t i: clauseOrder) {
+            renumbered.push_back(std::move(clauses[i]));
+        }
+        clauses = std::move(renumbered);
+
+        for (Lit& lit: rootLiterals) {
+            lit = renumber(lit);
+        }
+
+        for (Equivalences::Substitution& substitution: substitutions) {
+            substitution.variable = ids[substitution.variable - 1];
+            substitution.literal = renumber(substitution.literal);
+        }
+        std::sort(substitutions.begin(), substitutions.end(), [](const Equivalences::Substitution& x, const Equivalences::Substitution& y) {
+            return x.variable < y.variable;
+        });
+
+        return originalIds;
+    }
+
+    //maps the model to the new ids. Variables of the model that are not part of the formula keep their ids
+    inline Model renumber(const Model& model, const std::vector<unsigned int>& originalIds) {
+        Model renumbered(originalIds.size());
+        std::size_t nrMapped = 0;
+
+        for (unsigned int i = 0; i < originalIds.size(); i++) {
+            if (model.contains(originalIds[i])) {
+                int id = static_cast<int>(i + 1);
+                renumbered.assign(ModelVar(model.get(originalIds[i]) == Assignment::TRUE ? id : -id));
+                nrMapped += 1;
+            }
+        }
+
+        for (unsigned int id = originalIds.size() + 1; nrMapped < model.size(); id++) {
+            if (model.contains(id)) {
+                renumbered.assign(ModelVar(model.get(id) == Assignment::TRUE ? static_cast<int>(id) : -static_cast<int>(id)));
+                nrMapped += 1;
+            }
+        }
+
+        return renumbered;
+    }
+
+    //maps the values of the new ids back to the original ids
+    inline std::vector<Assignment> restore(const std::vector<Assignment>& values, const std::vector<unsigned int>& originalIds) {
+        std::vector<Assignment> restored(values);
+        for (unsigned int i = 0; i < originalIds.size(); i++) {
+            restored[originalIds[i] - 1] = values[i];
+        }
+
+        return restored;
+    }
+}
+
+#endif
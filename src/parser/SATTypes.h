@@ -2,6 +2,7 @@
 #define SRC_PARSER_SATTYPES_H_
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <vector>
 
 enum Assignment {
@@ -63,11 +64,101 @@ struct ModelVar
     }
 };
 
+//dense representation of a model. Two bitsets store which variables are assigned and their values,
+//variables that are not contained in the model are OPEN
+class Model
+{
+    private:
+        std::vector<uint64_t> assignedBits;
+        std::vector<uint64_t> valueBits;
+        std::size_t nrAssigned;
+
+        void reserveVariable(unsigned int id) {
+            std::size_t word = id >> 6;
+
+            if (word >= assignedBits.size()) {
+                assignedBits.resize(word + 1, 0);
+                valueBits.resize(word + 1, 0);
+            }
+        }
+
+    public:
+        explicit Model(unsigned int nrVariables = 0) : nrAssigned(0) {
+            reserveVariable(nrVariables);
+        }
+
+        bool contains(unsigned int id) const {
+            std::size_t word = id >> 6;
+            return word < assignedBits.size() && ((assignedBits[word] >> (id & 63)) & 1);
+        }
+
+        Assignment get(unsigned int id) const {
+            if (!contains(id)) {
+                return Assignment::OPEN;
+            }
+
+            return ((valueBits[id >> 6] >> (id & 63)) & 1) ? Assignment::TRUE : Assignment::FALSE;
+        }
+
+        //returns false if the variable is already assigned
+        bool assign(ModelVar var) {
+            if (contains(var.id)) {
+                return false;
+            }
+
+            reserveVariable(var.id);
+
+            uint64_t mask = static_cast<uint64_t>(1) << (var.id & 63);
+            assignedBits[var.id >> 6] |= mask;
+
+            if (var.assignment == Assignment::TRUE) {
+                valueBits[var.id >> 6] |= mask;
+            }
+
+            nrAssigned += 1;
+            return true;
+        }
+
+        //number of variables that are assigned in the model
+        std::size_t size() const {
+            return nrAssigned;
+        }
+};
+
+//entry of the lists that the propagation walks when a literal becomes false. A binary clause is stored as the literal it implies,
+//so the propagation does not have to read the clause, all other clauses are stored as pointers. The lowest bit marks binary
+//clauses, it is always zero in a pointer to a clause
+class Implication
+{
+    private:
+        uintptr_t value;
+
+    public:
+        explicit Implication(Cl* clause) : value(reinterpret_cast<uintptr_t>(clause)) {}
+
+        explicit Implication(Lit lit) : value((static_cast<uintptr_t>(lit.id) << 2) | (static_cast<uintptr_t>(lit.negative) << 1) | 1) {}
+
+        bool isBinary() const {
+            return (value & 1) != 0;
+        }
+
+        Cl* clause() const {
+            return reinterpret_cast<Cl*>(value);
+        }
+
+        Lit implied() const {
+            return Lit(static_cast<unsigned int>(value >> 2), ((value >> 1) & 1) != 0);
+        }
+};
+
 struct Var
 {
     unsigned int id;
     std::vector<Cl*> posOccList;
     std::vector<Cl*> negOccList; 
+    //same order as the occurence lists, they are built from them by Parser::buildImplicationLists
+    std::vector<Implication> posImplications;
+    std::vector<Implication> negImplications;
 
     Var(unsigned int id) : id(id) {}
 
@@ -0,0 +1,104 @@
+#ifndef SRC_PARSER_WORKSPACE_H_
+#define SRC_PARSER_WORKSPACE_H_
+
+#include <vector>
+#include <memory>
+
+#include "SATTypes.h"
+#include "Parser.h"
+#include "Heuristics.h"
+#include "ParsedFormulaCache.h"
+
+//buffers of the search of one model, they are cleared before every model and keep their capacity
+struct SearchBuffers {
+    std::vector<unsigned int> trail;
+    std::vector<bool> bitvector;
+    std::vector<unsigned int> dontCareVars;
+    std::vector<uint32_t> outputEncoding;
+
+    void clear() {
+        trail.clear();
+        bitvector.clear();
+        dontCareVars.clear();
+        outputEncoding.clear();
+    }
+};
+
+//state of the compression or the decompression that is reused by the models of a batch, every worker has its own workspace.
+//The clauses and the occurence and implication lists only depend on the formula, so they are kept while the models belong to the
+//same formula and only the literals of the clauses that the search satisfied are restored
+class Workspace {
+    private:
+        //the prepared formula the clauses were copied from and the hash of its file in the formula cache, if the cache is used
+        std::shared_ptr<const ParsedFormula> formula;
+        uint64_t formulaHash = 0;
+
+        //restores the clauses and removes the variables that were added because of the last model.
+        //The clauses vector keeps its size, so the occurence lists still point to the same clauses
+        std::shared_ptr<const ParsedFormula> restore() {
+            for (std::size_t i = 0; i < clauses.size(); i++) {
+                clauses[i] = formula->clauses[i];
+            }
+
+            variables.erase(variables.begin() + formula->nrVariables, variables.end());
+
+            return formula;
+        }
+
+    public:
+        std::vector<Cl> clauses;
+        std::vector<Var> variables;
+        InitialScores initialScores;
+        std::vector<Assignment> values;
+        SearchBuffers search;
+        //workspaces of the other heuristics of a portfolio, every heuristic searches in its own copy of the clauses
+        std::vector<Workspace> portfolio;
+
+        //returns the formula and restores its clauses if the workspace contains the formula with the hash of the formula cache
+        std::shared_ptr<const ParsedFormula> find(uint64_t formulaHash) {
+            if (formula == nullptr || formulaHash == 0 || this->formulaHash != formulaHash) {
+                return nullptr;
+            }
+
+            return restore();
+        }
+
+        //returns the formula and restores its clauses if the workspace contains the given parsed formula
+        std::shared_ptr<const ParsedFormula> find(const std::shared_ptr<const ParsedFormula>& parsedFormula) {
+            if (formula == nullptr || formula != parsedFormula) {
+                return nullptr;
+            }
+
+            return restore();
+        }
+
+        //copies the clauses of the formula and builds the occurence lists
+        void assign(std::shared_ptr<const ParsedFormula> parsedFormula, uint64_t formulaHash, unsigned int nrThreads) {
+            formula = nullptr;
+
+            clauses = parsedFormula->clauses;
+            variables.clear();
+            variables.reserve(parsedFormula->nrVariables);
+            for (unsigned int i = 1; i <= parsedFormula->nrVariables; i++) {
+                variables.push_back(Var(i));
+            }
+
+            Parser::buildOccurenceLists(clauses, variables, nrThreads);
+
+            formula = parsedFormula;
+            this->formulaHash = formulaHash;
+        }
+
+        //takes the clauses and the occurence lists that were restored from the formula cache into this workspace
+        void assignLoaded(std::shared_ptr<const ParsedFormula> parsedFormula, uint64_t formulaHash) {
+            formula = parsedFormula;
+            this->formulaHash = formulaHash;
+        }
+
+        //builds the implication lists, they are built after the formula was stored in the formula cache
+        void buildImplicationLists(unsigned int nrThreads) {
+            Parser::buildImplicationLists(variables, nrThreads);
+        }
+};
+
+#endif
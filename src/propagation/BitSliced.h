@@ -0,0 +1,321 @@
+#ifndef SRC_PROPAGATION_BITSLICED_H_
+#define SRC_PROPAGATION_BITSLICED_H_
+
+#include <vector>
+#include <bit>
+#include <deque>
+#include <utility>
+
+#include "SATTypes.h"
+
+//search of up to 64 models of the same formula at once for the heuristics with a static order and static predictions.
+//Every model is a lane of a 64 bit mask, so the assignment of a variable and the satisfied clauses are stored as one mask for all models
+//and the propagation of a variable handles all models that assigned it in the same step with bitwise operations.
+//The unit propagation of a satisfying model never reaches a conflict, so it ends in the same assignment for every order of the
+//propagated variables and the lanes make the same decisions as the search of a single model. A lane that reaches a conflict or
+//runs out of variables is marked as failed and its model has to be searched alone
+namespace BitSliced {
+
+    constexpr unsigned int LANES = 64;
+
+    //decisions of one model, the same values as the search of a single model produces
+    struct Lane {
+        bool failed = false;
+        std::vector<bool> bitvector;
+        std::vector<unsigned int> dontCareVars;
+        unsigned int propagatedDontCareVars = 0;
+        uint64_t predictionMisses = 0;
+        uint64_t nrPredictions = 0;
+        bool flipPredictionModel = false;
+        uint64_t predictionDistance = 0;
+        //number of clauses that are not satisfied yet, the search of the lane ends if it reaches zero
+        std::size_t nrOpenClauses = 0;
+    };
+
+    inline uint64_t laneMask(unsigned int lane) {
+        return static_cast<uint64_t>(1) << lane;
+    }
+
+    class Search {
+        private:
+            const std::vector<Cl>& clauses;
+            const std::vector<Var>& variables;
+            //lanes in which a variable is assigned and its value in these lanes
+            std::vector<uint64_t> assigned;
+            std::vector<uint64_t> values;
+            //lanes in which a clause is satisfied by a propagated literal
+            std::vector<uint64_t> satisfied;
+            //variables and the lanes in which they were assigned but not propagated yet
+            std::deque<std::pair<unsigned int, uint64_t>> queue;
+            //counters of the false literals of the clauses, bit i of the count of a lane is stored in plane i of the clause.
+            //The planes of a clause start at its offset and there are as many as the bits of its length
+            std::vector<uint64_t> counters;
+            std::vector<std::size_t> counterOffsets;
+            uint64_t failedLanes = 0;
+            std::vector<Lane>& lanes;
+
+            //adds one to the counters of the lanes of the mask with a ripple carry through the planes
+            static void increment(uint64_t* planes, std::size_t width, uint64_t mask) {
+                for (std::size_t i = 0; i < width && mask != 0; i++) {
+                    uint64_t carry = planes[i] & mask;
+                    planes[i] ^= mask;
+                    mask = carry;
+                }
+            }
+
+            //lanes whose counter is equal to the count
+            static uint64_t countEquals(const uint64_t* planes, std::size_t width, std::size_t count) {
+                uint64_t equal = ~static_cast<uint64_t>(0);
+
+                for (std::size_t i = 0; i < width; i++) {
+                    equal &= (count >> i) & 1 ? planes[i] : ~planes[i];
+                }
+
+                return count >> width == 0 ? equal : 0;
+            }
+
+            void assign(Lit lit, uint64_t mask) {
+                if (mask == 0) {
+                    return;
+                }
+
+                assigned[lit.id - 1] |= mask;
+
+                if (lit.negative) {
+                    values[lit.id - 1] &= ~mask;
+                } else {
+                    values[lit.id - 1] |= mask;
+                }
+
+                queue.emplace_back(lit.id, mask);
+            }
+
+            void satisfy(const Cl* clause, uint64_t mask) {
+                uint64_t& clauseMask = satisfied[clause - clauses.data()];
+                uint64_t newlySatisfied = mask & ~clauseMask;
+
+                if (newlySatisfied == 0) {
+                    return;
+                }
+
+                clauseMask |= newlySatisfied;
+
+                for (; newlySatisfied != 0; newlySatisfied &= newlySatisfied - 1) {
+                    lanes[__builtin_ctzll(newlySatisfied)].nrOpenClauses -= 1;
+                }
+            }
+
+            //a literal of the clause became false in the lanes of the mask. The number of false literals of a clause is counted per lane
+            //in the bit planes of its counter, a literal that occurs twice counts twice like in the counters of the single search.
+            //The clause is a conflict in the lanes in which all literals are false and unit in the lanes in which all but one are false,
+            //only these lanes look at the literals again to find the open one
+            void checkClause(const Cl* clause, uint64_t mask) {
+                std::size_t index = clause - clauses.data();
+                mask &= ~satisfied[index];
+
+                if (mask == 0) {
+                    return;
+                }
+
+                uint64_t* planes = counters.data() + counterOffsets[index];
+                std::size_t width = counterOffsets[index + 1] - counterOffsets[index];
+                std::size_t length = clause->literals.size();
+
+                increment(planes, width, mask);
+                failedLanes |= mask & countEquals(planes, width, length);
+
+                //a lane whose clause is satisfied by a literal that is not propagated yet has no open literal
+                uint64_t unit = mask & countEquals(planes, width, length - 1);
+
+                for (Lit lit: clause->literals) {
+                    if (unit == 0) {
+                        break;
+                    }
+
+                    uint64_t implied = unit & ~assigned[lit.id - 1];
+
+                    if (implied != 0) {
+                        assign(lit, implied);
+                        unit &= ~implied;
+                    }
+                }
+            }
+
+            void propagate() {
+                while (!queue.empty()) {
+                    auto [id, mask] = queue.front();
+                    queue.pop_front();
+
+                    const Var& var = variables[id - 1];
+                    uint64_t trueLanes = mask & values[id - 1];
+                    uint64_t falseLanes = mask & ~values[id - 1];
+
+                    for (const Cl* clause: var.posOccList) {
+                        satisfy(clause, trueLanes);
+                    }
+                    for (const Cl* clause: var.negOccList) {
+                        satisfy(clause, falseLanes);
+                    }
+
+                    for (const Cl* clause: var.negOccList) {
+                        checkClause(clause, trueLanes);
+                    }
+                    for (const Cl* clause: var.posOccList) {
+                        checkClause(clause, falseLanes);
+                    }
+                }
+            }
+
+        public:
+            //the occurence lists of the variables must point into the clauses. The clauses are only read
+            Search(const std::vector<Cl>& clauses, const std::vector<Var>& variables, std::vector<Lane>& lanes)
+                : clauses(clauses), variables(variables), assigned(variables.size(), 0), values(variables.size(), 0), satisfied(clauses.size(), 0), lanes(lanes) {
+                counterOffsets.reserve(clauses.size() + 1);
+                counterOffsets.push_back(0);
+
+                for (const Cl& clause: clauses) {
+                    counterOffsets.push_back(counterOffsets.back() + std::bit_width(clause.literals.size()));
+                }
+
+                counters.resize(counterOffsets.back(), 0);
+            }
+
+            //searches the models in the order of the static heuristic. The values contain the assignments before the first decision,
+            //they are the same for all models. The rest of the open variables gets a bit if the model is not faithful or if
+            //don't care variables were decided, like in the search of a single model
+            void run(const std::vector<unsigned int>& order, const std::vector<Assignment>& predictions, const std::vector<Model>& models,
+                     const std::vector<Assignment>& initialValues, unsigned int predictionFlip, bool disableFaithfulMode) {
+                uint64_t allLanes = models.size() == LANES ? ~static_cast<uint64_t>(0) : laneMask(models.size()) - 1;
+
+                for (std::size_t i = 0; i < initialValues.size(); i++) {
+                    if (initialValues[i] != Assignment::OPEN) {
+                        assigned[i] = allLanes;
+                        values[i] = initialValues[i] == Assignment::TRUE ? allLanes : 0;
+                    }
+                }
+
+                //an empty clause counts as satisfied in the search of a single model. The counters start with the literals that are
+                //false before the first decision in all lanes
+                std::size_t nrClauses = 0;
+                for (std::size_t i = 0; i < clauses.size(); i++) {
+                    const std::vector<Lit>& literals = clauses[i].literals;
+                    nrClauses += literals.empty() ? 0 : 1;
+
+                    std::size_t nrFalse = 0;
+                    for (Lit lit: literals) {
+                        Assignment value = initialValues[lit.id - 1];
+                        nrFalse += value != Assignment::OPEN && (value == Assignment::TRUE) == lit.negative ? 1 : 0;
+                    }
+
+                    for (std::size_t plane = counterOffsets[i]; nrFalse != 0; plane++, nrFalse >>= 1) {
+                        counters[plane] = nrFalse & 1 ? allLanes : 0;
+                    }
+                }
+                for (Lane& lane: lanes) {
+                    lane.nrOpenClauses = nrClauses;
+                }
+
+                //lanes that decide variables and lanes that only write the bits of the rest of the open variables
+                uint64_t searchLanes = allLanes;
+                uint64_t restLanes = 0;
+
+                for (unsigned int id: order) {
+                    Assignment prediction = predictions[id - 1];
+                    uint64_t open = ~assigned[id - 1];
+
+                    for (uint64_t rest = restLanes & open; rest != 0; rest &= rest - 1) {
+                        unsigned int lane = __builtin_ctzll(rest);
+
+                        if (models[lane].contains(id)) {
+                            lanes[lane].bitvector.push_back(models[lane].get(id) == prediction);
+                        } else {
+                            lanes[lane].bitvector.push_back(true);
+                            lanes[lane].dontCareVars.push_back(id);
+                        }
+                    }
+
+                    uint64_t deciding = searchLanes & open;
+                    if (deciding == 0) {
+                        continue;
+                    }
+
+                    uint64_t trueLanes = 0;
+
+                    for (uint64_t decisions = deciding; decisions != 0; decisions &= decisions - 1) {
+                        unsigned int index = __builtin_ctzll(decisions);
+                        Lane& lane = lanes[index];
+                        Assignment value;
+
+                        //if no model value exists for the variable it is assigned according to the prediction model
+                        if (!models[index].contains(id)) {
+                            value = prediction;
+                            lane.dontCareVars.push_back(id);
+                        } else {
+                            value = models[index].get(id);
+                        }
+
+                        if (value == Assignment::TRUE) {
+                            trueLanes |= laneMask(index);
+                        }
+
+                        if (lane.predictionDistance == predictionFlip) {
+                            lane.flipPredictionModel = !lane.flipPredictionModel;
+                        }
+
+                        lane.nrPredictions += 1;
+
+                        if (value != prediction) {
+                            lane.bitvector.push_back(lane.flipPredictionModel);
+                            if (!lane.flipPredictionModel) {
+                                lane.predictionDistance += 1;
+                                lane.predictionMisses += 1;
+                            } else {
+                                lane.predictionDistance = 0;
+                            }
+                        } else {
+                            lane.bitvector.push_back(!lane.flipPredictionModel);
+
+                            if (lane.flipPredictionModel) {
+                                lane.predictionMisses += 1;
+                                lane.predictionDistance += 1;
+                            } else {
+                                lane.predictionDistance = 0;
+                            }
+                        }
+                    }
+
+                    assign(Lit(id, false), trueLanes);
+                    assign(Lit(id, true), deciding & ~trueLanes);
+                    propagate();
+
+                    searchLanes &= ~failedLanes;
+
+                    //the lanes whose clauses are all satisfied stop deciding
+                    for (uint64_t decisions = deciding & ~failedLanes; decisions != 0; decisions &= decisions - 1) {
+                        unsigned int index = __builtin_ctzll(decisions);
+                        Lane& lane = lanes[index];
+
+                        if (lane.nrOpenClauses != 0) {
+                            continue;
+                        }
+
+                        searchLanes &= ~laneMask(index);
+                        lane.propagatedDontCareVars = lane.dontCareVars.size();
+
+                        if ((!disableFaithfulMode && lane.nrPredictions != models[index].size()) || lane.propagatedDontCareVars != 0) {
+                            restLanes |= laneMask(index);
+                        }
+                    }
+                }
+
+                //the single search runs out of variables in these lanes
+                failedLanes |= searchLanes;
+
+                for (unsigned int i = 0; i < models.size(); i++) {
+                    lanes[i].failed = (failedLanes & laneMask(i)) != 0;
+                }
+            }
+    };
+}
+
+#endif
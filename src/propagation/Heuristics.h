@@ -4,19 +4,112 @@
 #include <deque>
 #include <algorithm>
 #include <math.h>
+#include <cstdint>
 #include <set>
 #include <queue>
 #include <map>
+#include <array>
+#include <thread>
 
 #include "SATTypes.h"
 #include "Heap.h"
+#include "Parallel.h"
 
-//abstract base class
+//exact scores for the Jeroslow-Wang based heuristics. The weight 2^-length of a clause is stored as an integer with a fixed
+//number of fraction bits, so the sums do not depend on the order of the additions or the floating point settings of the build
+namespace FixedPoint {
+    typedef unsigned __int128 Score;
+
+    //clauses that are longer than the number of fraction bits have the weight 0. With 96 fraction bits the sum of 2^31 weights still fits
+    constexpr unsigned int FRACTION_BITS = 96;
+
+    constexpr std::array<Score, FRACTION_BITS + 1> WEIGHTS = []() {
+        std::array<Score, FRACTION_BITS + 1> weights{};
+        for (unsigned int length = 0; length <= FRACTION_BITS; length++) {
+            weights[length] = static_cast<Score>(1) << (FRACTION_BITS - length);
+        }
+        return weights;
+    }();
+
+    inline Score weight(std::size_t clauseLength) {
+        return clauseLength <= FRACTION_BITS ? WEIGHTS[clauseLength] : 0;
+    }
+}
+
+//parameter independent initial values of the heuristics. They only depend on the formula and can therefore be restored from the formula cache
+struct InitialScores {
+    std::vector<double> jeroslowWangPos;
+    std::vector<double> jeroslowWangNeg;
+    unsigned int minClauseLength = 0;
+    unsigned int nrMinClauses = 0;
+    std::vector<unsigned int> momsPosCounts;
+    std::vector<unsigned int> momsNegCounts;
+
+    //the values of the variables are computed with the given number of threads, every variable is computed by a single thread
+    static InitialScores compute(const std::vector<Var>& variables, const std::vector<Cl>& clauses, unsigned int nrThreads = 1) {
+        InitialScores scores;
+
+        //determine the length and the number of the shortest clauses that are not empty
+        for (const Cl& clause: clauses) {
+            unsigned int size = clause.literals.size();
+
+            if (size == 0) {
+                continue;
+            } else if (scores.minClauseLength == 0 || size < scores.minClauseLength) {
+                scores.minClauseLength = size;
+                scores.nrMinClauses = 1;
+            } else if (size == scores.minClauseLength) {
+                scores.nrMinClauses += 1;
+            }
+        }
+
+        scores.jeroslowWangNeg.resize(variables.size(), 0);
+        scores.jeroslowWangPos.resize(variables.size(), 0);
+        scores.momsNegCounts.resize(variables.size(), 0);
+        scores.momsPosCounts.resize(variables.size(), 0);
+
+        Parallel::forChunks(variables.size(), nrThreads, [&](unsigned int /*chunk*/, std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                for (Cl* clause: variables[i].negOccList) {
+                    if (clause->literals.size() > 0) {
+                        scores.jeroslowWangNeg[i] += pow(2, -static_cast<double>(clause->literals.size()));
+                    }
+                    if (clause->literals.size() == scores.minClauseLength) {
+                        scores.momsNegCounts[i] += 1;
+                    }
+                }
+
+                for (Cl* clause: variables[i].posOccList) {
+                    if (clause->literals.size() > 0) {
+                        scores.jeroslowWangPos[i] += pow(2, -static_cast<double>(clause->literals.size()));
+                    }
+                    if (clause->literals.size() == scores.minClauseLength) {
+                        scores.momsPosCounts[i] += 1;
+                    }
+                }
+            }
+        });
+
+        return scores;
+    }
+};
+
+//base class with the variable order and the predictions. The heuristics are used as template parameters of the compression and
+//decompression, so every heuristic implements updateVariables(Cl*) and a static create function without virtual dispatch.
+//Static and dynamic variants are separate instantiations, the static variants ignore all updates at compile time
 class Heuristic {
 
     protected:
         struct VarComparator {
-            bool operator()(Var x, Var y) const {
+            bool operator()(const Var& x, const Var& y) const {
+                if (compareFixedPoint) {
+                    if (fixedPointValues[x.id] == fixedPointValues[y.id]) {
+                        return x.id < y.id;
+                    }
+
+                    return fixedPointValues[x.id] > fixedPointValues[y.id];
+                }
+
                 if (heuristicValues[x.id] == heuristicValues[y.id]) {
                     return x.id < y.id;
                 }
@@ -25,23 +118,198 @@ class Heuristic {
             }
         };
 
-        std::vector<Var> variables;
-        bool dynamicHeuristic;
+        //the variables and their occurence lists belong to the compression, the heuristic only reads them.
+        //The heap and the order only contain the ids of the variables, so no occurence list is copied
+        const std::vector<Var>& variables;
         Minisat::Heap<Var, VarComparator> variablesHeap = Minisat::Heap<Var, VarComparator>(VarComparator());
-        std::map<unsigned int, bool> activeVariables;
+
+        //the values of the static heuristics never change, so their variables are sorted once and handed out by advancing the position instead of using the heap
+        bool presorted;
+        std::vector<unsigned int> order;
+        std::size_t orderPosition = 0;
+        //indexed by the id, a variable is active until it is handed out
+        std::vector<bool> activeVariables;
+        //indexed by the id minus one, every heuristic sets the prediction of all variables when it is created
         std::vector<Assignment> predictedAssignments;
+        //values of the reference model, they replace the predictions of the heuristic for the variables the reference assigns
+        const std::vector<Assignment>* referenceValues = nullptr;
+        //trained polarity priors of the formula, they replace the predictions of the heuristic for the variables that have a prior
+        const std::vector<Assignment>* priorValues = nullptr;
+
+        //variables whose values changed since the last decision. The heap is only repaired before the next variable is taken,
+        //so a variable that occurs in many satisfied clauses of a propagation round is moved once instead of once per clause.
+        //A raised value can move the variable towards the root, which needs a larger repair, so these variables are kept separately
+        std::vector<Var> dirtyVariables;
+        std::vector<Var> raisedVariables;
+        std::vector<bool> isDirty;
+        std::vector<bool> isRaised;
+
+        //a variable whose value was raised and lowered in the same round is marked for both
+        void markDirty(unsigned int id, bool raised = false) {
+            std::vector<bool>& marked = raised ? isRaised : isDirty;
+
+            if (id >= marked.size()) {
+                marked.resize(id + 1, false);
+            }
 
-    public:
-        static std::map<unsigned int, double> heuristicValues;
+            if (!marked[id]) {
+                marked[id] = true;
+                (raised ? raisedVariables : dirtyVariables).push_back(Var(id));
+            }
+        }
+
+        void clearDirty() {
+            for (Var var: dirtyVariables) {
+                isDirty[var.id] = false;
+            }
+
+            for (Var var: raisedVariables) {
+                isRaised[var.id] = false;
+            }
+
+            dirtyVariables.clear();
+            raisedVariables.clear();
+        }
+
+        void repairHeap() {
+            if (dirtyVariables.empty() && raisedVariables.empty()) {
+                return;
+            }
+
+            //a lower value is a larger key of the heap
+            variablesHeap.updateAll(dirtyVariables, raisedVariables);
+            clearDirty();
+        }
+
+        //adds the variable to the heap or to the order of the static heuristics. The heuristic value has to be set before
+        void addVariable(const Var& var) {
+            if (presorted) {
+                order.push_back(var.id);
+            } else {
+                variablesHeap.insert(Var(var.id));
+            }
+        }
+
+        //same order as the comparator of the heap, the ids are unique so the order is total
+        template<typename T>
+        static void sortByValues(std::vector<std::pair<T, unsigned int>>& keys, unsigned int nrThreads) {
+            auto compare = [](const std::pair<T, unsigned int>& x, const std::pair<T, unsigned int>& y) {
+                if (x.first == y.first) {
+                    return x.second < y.second;
+                }
+
+                return x.first > y.first;
+            };
+
+            if (nrThreads <= 1) {
+                std::sort(keys.begin(), keys.end(), compare);
+                return;
+            }
+
+            //sort the chunks in parallel and merge them pairwise afterwards
+            Parallel::forChunks(keys.size(), nrThreads, [&](unsigned int /*chunk*/, std::size_t begin, std::size_t end) {
+                std::sort(keys.begin() + begin, keys.begin() + end, compare);
+            });
+
+            for (unsigned int width = 1; width < nrThreads; width *= 2) {
+                for (unsigned int i = 0; i + width < nrThreads; i += 2 * width) {
+                    std::size_t begin = Parallel::chunkBegin(keys.size(), nrThreads, i);
+                    std::size_t middle = Parallel::chunkBegin(keys.size(), nrThreads, i + width);
+                    std::size_t end = Parallel::chunkBegin(keys.size(), nrThreads, std::min(i + 2 * width, nrThreads));
+                    std::inplace_merge(keys.begin() + begin, keys.begin() + middle, keys.begin() + end, compare);
+                }
+            }
+        }
+
+        template<typename T>
+        void sortOrder(const std::map<unsigned int, T>& values) {
+            std::vector<std::pair<T, unsigned int>> keys;
+            keys.reserve(order.size());
+
+            for (unsigned int id: order) {
+                keys.emplace_back(values.at(id), id);
+            }
+
+            //only large formulas are sorted with multiple threads
+            unsigned int nrThreads = 1;
+            if (keys.size() >= PARALLEL_SORT_THRESHOLD) {
+                nrThreads = std::max(1u, std::min(std::thread::hardware_concurrency(), 8u));
+            }
+
+            sortByValues(keys, nrThreads);
 
-        explicit Heuristic(std::vector<Var> variables, bool dynamicHeuristic) : variables(variables), dynamicHeuristic(dynamicHeuristic) {
+            for (std::size_t i = 0; i < keys.size(); i++) {
+                order[i] = keys[i].second;
+            }
         }
 
-        virtual ~Heuristic() {}
+        //sorts the variables of the static heuristics after all variables were added
+        void sortOrder() {
+            if (!presorted) {
+                return;
+            }
 
-        virtual void updateVariables(Cl* clause) = 0;
+            if (compareFixedPoint) {
+                sortOrder(fixedPointValues);
+            } else {
+                sortOrder(heuristicValues);
+            }
+        }
+
+        //sums the weights of the clauses in the occurence lists of every variable, satisfied clauses and clauses that are longer than the cutoff are skipped.
+        //Every variable is summed by a single thread in the order of its occurence lists, so the values do not depend on the number of threads
+        template<typename T, typename Weight>
+        static void sumWeights(const std::vector<Var>& variables, std::size_t lengthCutoff, unsigned int nrThreads, Weight weight, std::vector<T>& negValues, std::vector<T>& posValues) {
+            negValues.assign(variables.size(), 0);
+            posValues.assign(variables.size(), 0);
+
+            Parallel::forChunks(variables.size(), nrThreads, [&](unsigned int /*chunk*/, std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; i++) {
+                    for (Cl* clause: variables[i].negOccList) {
+                        if (clause->literals.size() > 0 && clause->literals.size() <= lengthCutoff) {
+                            negValues[i] += weight(clause->literals.size());
+                        }
+                    }
+
+                    for (Cl* clause: variables[i].posOccList) {
+                        if (clause->literals.size() > 0 && clause->literals.size() <= lengthCutoff) {
+                            posValues[i] += weight(clause->literals.size());
+                        }
+                    }
+                }
+            });
+        }
+
+        static double jeroslowWangWeight(std::size_t clauseLength) {
+            return pow(2, -static_cast<double>(clauseLength));
+        }
+
+    public:
+        static constexpr std::size_t PARALLEL_SORT_THRESHOLD = 1 << 17;
+
+        //the values are shared by the comparator of the heap. They are separate for every thread, so the components of a formula
+        //can be compressed by heuristics on different threads
+        static thread_local std::map<unsigned int, double> heuristicValues;
+        //values of the heuristics that use fixed-point scores, they are compared instead of the heuristic values if compareFixedPoint is set
+        static thread_local std::map<unsigned int, FixedPoint::Score> fixedPointValues;
+        static thread_local bool compareFixedPoint;
+
+        //the variables must outlive the heuristic and must not be changed while it is used
+        explicit Heuristic(const std::vector<Var>& variables, bool presorted = false) : variables(variables), presorted(presorted), activeVariables(variables.size() + 1, false), predictedAssignments(variables.size(), Assignment::TRUE) {
+            compareFixedPoint = false;
+        }
 
         Var getNextVar() {
+            if (presorted) {
+                if (orderPosition == order.size()) {
+                    throw std::runtime_error("Error, the model is not satisfying!");
+                }
+
+                return Var(order[orderPosition++]);
+            }
+
+            repairHeap();
+
             if (variablesHeap.empty()) {
                 throw std::runtime_error("Error, the model is not satisfying!");
             }
@@ -54,10 +322,32 @@ class Heuristic {
         }
 
         Assignment getPredictedAssignment(Var var) {
+            if (referenceValues != nullptr && var.id <= referenceValues->size() && (*referenceValues)[var.id - 1] != Assignment::OPEN) {
+                return (*referenceValues)[var.id - 1];
+            }
+
+            if (priorValues != nullptr && var.id <= priorValues->size() && (*priorValues)[var.id - 1] != Assignment::OPEN) {
+                return (*priorValues)[var.id - 1];
+            }
+
             return predictedAssignments[var.id - 1];
         }
 
+        //the values must outlive the heuristic, the order of the variables is not changed by the reference
+        void setReference(const std::vector<Assignment>* values) {
+            referenceValues = values;
+        }
+
+        //the values must outlive the heuristic, a reference takes precedence over the priors
+        void setPriors(const std::vector<Assignment>* values) {
+            priorValues = values;
+        }
+
         bool hasNextVar() {
+            if (presorted) {
+                return orderPosition < order.size();
+            }
+
             return !variablesHeap.empty();
         }
 };
@@ -67,22 +357,29 @@ class ParsingOrder: public Heuristic {
         std::vector<unsigned int> posOccurences;
         std::vector<unsigned int> negOccurences;
     public:
-        ParsingOrder(std::vector<Var> variables) : Heuristic(variables, false) {
-            for (Var var: variables) {
+        template<class Setup>
+        static ParsingOrder* create(std::vector<Var>& variables, std::vector<Cl>& /*clauses*/, const Setup& /*setup*/, const InitialScores* /*initialScores*/) {
+            return new ParsingOrder(variables);
+        }
+
+        ParsingOrder(const std::vector<Var>& variables) : Heuristic(variables, true) {
+            for (const Var& var: variables) {
                 //invert the id so that the smallest id gets assigned first because of max heap
                 heuristicValues[var.id] = var.id * -1.0;
-                variablesHeap.insert(var);
+                addVariable(var);
 
                 posOccurences.push_back(var.posOccList.size());
                 negOccurences.push_back(var.negOccList.size());
 
                 //predict the assignment based on the occurence counts
                 if (var.posOccList.size() >= var.negOccList.size()) {
-                    predictedAssignments.push_back(Assignment::TRUE);
+                    predictedAssignments[var.id - 1] = Assignment::TRUE;
                 } else {
-                    predictedAssignments.push_back(Assignment::FALSE);
+                    predictedAssignments[var.id - 1] = Assignment::FALSE;
                 }
             }
+
+            sortOrder();
         }
 
         void updateVariables(Cl* clause) {
@@ -103,62 +400,113 @@ class ParsingOrder: public Heuristic {
         }
 };
 
+template<bool Dynamic>
 class JeroslowWang: public Heuristic {
     private:
         std::vector<double> negHeuristicValues;
         std::vector<double> posHeuristicValues;
+        bool fixedPoint;
+        std::vector<FixedPoint::Score> negFixedPointValues;
+        std::vector<FixedPoint::Score> posFixedPointValues;
 
-    public:
-        explicit JeroslowWang(std::vector<Var> variables_, bool dynamic) : Heuristic(variables_, dynamic) {
-            for (Var var: variables_) {
-                double negHeuristicValue = 0;
-                double posHeuristicValue = 0;
+        void initFixedPoint(const std::vector<Var>& variables_, std::size_t lengthCutoff, unsigned int nrThreads) {
+            compareFixedPoint = true;
 
-                //std::cout << "neg size: " << var.negOccList.size() << ", pos size: " << var.posOccList.size() << std::endl;
+            sumWeights(variables_, lengthCutoff, nrThreads, FixedPoint::weight, negFixedPointValues, posFixedPointValues);
 
-                for (Cl* clause: var.negOccList) {
-                    if (clause->literals.size() > 0) {
-                        double clauseSize = static_cast<double>(clause->literals.size());
-                        negHeuristicValue += pow(2, -clauseSize);
+            for (std::size_t i = 0; i < variables_.size(); i++) {
+                const Var& var = variables_[i];
+
+                fixedPointValues[var.id] = negFixedPointValues[i] + posFixedPointValues[i];
+                activeVariables[var.id] = true;
+                addVariable(var);
+
+                predictedAssignments[var.id - 1] = posFixedPointValues[i] >= negFixedPointValues[i] ? Assignment::TRUE : Assignment::FALSE;
+            }
+
+            sortOrder();
+        }
+
+        void updateFixedPoint(Cl* clause) {
+            FixedPoint::Score updateValue = FixedPoint::weight(clause->literals.size());
+
+            for (Lit lit: clause->literals) {
+                if (activeVariables[lit.id]) {
+                    fixedPointValues[lit.id] -= updateValue;
+
+                    markDirty(lit.id);
+
+                    if (lit.negative) {
+                        negFixedPointValues[lit.id - 1] -= updateValue;
+                    } else {
+                        posFixedPointValues[lit.id - 1] -= updateValue;
+                    }
+
+                    if (posFixedPointValues[lit.id - 1] >= negFixedPointValues[lit.id - 1]) {
+                        predictedAssignments[lit.id - 1] = Assignment::TRUE;
+                    } else {
+                        predictedAssignments[lit.id - 1] = Assignment::FALSE;
                     }
                 }
+            }
+        }
 
-                negHeuristicValues.push_back(negHeuristicValue);
+    public:
+        //the fixed-point mode computes the same heuristic with exact integer scores, the precomputed floating point values are not used in this mode.
+        //The values of the variables are computed with the given number of threads
+        explicit JeroslowWang(const std::vector<Var>& variables_, const InitialScores* initialScores = nullptr, bool fixedPoint = false, unsigned int nrThreads = 1) : Heuristic(variables_, !Dynamic), fixedPoint(fixedPoint) {
+            if (fixedPoint) {
+                initFixedPoint(variables_, SIZE_MAX, nrThreads);
+                return;
+            }
 
-                for (Cl* clause: var.posOccList) {
-                    if (clause->literals.size() > 0) {
-                        double clauseSize = static_cast<double>(clause->literals.size());
-                        posHeuristicValue += pow(2, -clauseSize);
-                    }
+            //use the precomputed values if they are available, variables that were added because of the model have no occurences
+            if (initialScores != nullptr) {
+                for (const Var& var: variables_) {
+                    bool precomputed = var.id <= initialScores->jeroslowWangNeg.size();
+                    negHeuristicValues.push_back(precomputed ? initialScores->jeroslowWangNeg[var.id - 1] : 0);
+                    posHeuristicValues.push_back(precomputed ? initialScores->jeroslowWangPos[var.id - 1] : 0);
                 }
+            } else {
+                sumWeights(variables_, SIZE_MAX, nrThreads, jeroslowWangWeight, negHeuristicValues, posHeuristicValues);
+            }
 
-                posHeuristicValues.push_back(posHeuristicValue);
+            for (std::size_t i = 0; i < variables_.size(); i++) {
+                const Var& var = variables_[i];
 
-                //heuristicValues[var.id - 1] = heuristicValue;
-                heuristicValues[var.id] = negHeuristicValue + posHeuristicValue;
+                heuristicValues[var.id] = negHeuristicValues[i] + posHeuristicValues[i];
                 activeVariables[var.id] = true;
-                variablesHeap.insert(var);
-
-                //std::cout << "Var: " << var.id << ", heuristic value: " << heuristicValue << std::endl;
+                addVariable(var);
 
                 //use the positive and negative heuristic values to predict the assignment
-                if (posHeuristicValue >= negHeuristicValue) {
-                    predictedAssignments.push_back(Assignment::TRUE);
+                if (posHeuristicValues[i] >= negHeuristicValues[i]) {
+                    predictedAssignments[var.id - 1] = Assignment::TRUE;
                 } else {
-                    predictedAssignments.push_back(Assignment::FALSE);
+                    predictedAssignments[var.id - 1] = Assignment::FALSE;
                 }
-
             }
+
+            sortOrder();
+        }
+
+        template<class Setup>
+        static JeroslowWang* create(std::vector<Var>& variables, std::vector<Cl>& /*clauses*/, const Setup& setup, const InitialScores* initialScores) {
+            return new JeroslowWang(variables, initialScores, setup.fixedPointScores, setup.initThreads);
         }
 
         void updateVariables(Cl* clause) {
-            if (!dynamicHeuristic) {
+            if constexpr (!Dynamic) {
+                return;
+            }
+
+            if (fixedPoint) {
+                updateFixedPoint(clause);
                 return;
             }
 
             //update all variables in the clause
             for (Lit lit: clause->literals) {
-                Var& var = variables.at(lit.id - 1);
+                const Var& var = variables.at(lit.id - 1);
 
                 //std::cout << "Update variable: " << var.id << std::endl;
                 //remove the variable from the set and reinsert it to update the position
@@ -168,7 +516,7 @@ class JeroslowWang: public Heuristic {
                     
                     heuristicValues[var.id] -= updateValue;
 
-                    variablesHeap.increase(var);
+                    markDirty(var.id);
 
                     //update assignment prediction
                     if (lit.negative) {
@@ -187,41 +535,72 @@ class JeroslowWang: public Heuristic {
         }
 };
 
+template<bool Dynamic>
 class MomsFreeman: public Heuristic {
     private:
         double momsParameter;
         unsigned int minClauseLength;
         std::vector<Cl>& clauses;
         unsigned int nrMinClauses = 0;
+        //occurences of every variable in the unsatisfied clauses of minimum length, indexed by the id minus one
         std::vector<unsigned int> posCounts;
         std::vector<unsigned int> negCounts;
 
-        void calculateHeuristicValue(Var variable) {
-            unsigned int posCount = 0;
-            unsigned int negCount = 0;
+        //number of clauses of every length, satisfied clauses are counted with length 0.
+        //As the length of a clause only changes when it is satisfied, the minimum length can only grow
+        std::vector<unsigned int> nrClausesOfLength;
+        unsigned int nextMinClauseLength = 1;
 
-            for (Cl* clause: variable.negOccList) {
-                if (clause->literals.size() == minClauseLength) {
-                    negCount += 1;
-                }
-            }
+        //occurences of every variable counted by the length of the clauses. The lengths that occur for a variable are stored
+        //sorted in the range from lengthOffsets[id - 1] to lengthOffsets[id], the first entry of every variable is length 0
+        std::vector<std::size_t> lengthOffsets;
+        std::vector<unsigned int> occurenceLengths;
+        std::vector<unsigned int> posLengthCounts;
+        std::vector<unsigned int> negLengthCounts;
 
-            negCounts.push_back(negCount);
+        //position of the length counter for every literal of every clause, so that no search is necessary during the updates
+        std::vector<std::size_t> clauseSlotOffsets;
+        std::vector<std::size_t> literalSlots;
 
-            for (Cl* clause: variable.posOccList) {
-                if (clause->literals.size() == minClauseLength) {
-                    posCount += 1;
-                }
-            }
-
-            posCounts.push_back(posCount);
+        void setHeuristicValue(const Var& variable, unsigned int posCount, unsigned int negCount) {
+            negCounts[variable.id - 1] = negCount;
+            posCounts[variable.id - 1] = posCount;
 
             unsigned int heuristicValue = (posCount + negCount) * momsParameter + posCount * negCount;
 
             heuristicValues[variable.id] = heuristicValue;
         }
 
+        //counts the occurences of every variable in clauses of minimum length, the variables are split between the threads
+        void countMinClauses(const std::vector<Var>& variables, unsigned int nrThreads, std::vector<unsigned int>& posMinCounts, std::vector<unsigned int>& negMinCounts) {
+            posMinCounts.assign(variables.size(), 0);
+            negMinCounts.assign(variables.size(), 0);
+
+            Parallel::forChunks(variables.size(), nrThreads, [&](unsigned int /*chunk*/, std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; i++) {
+                    for (Cl* clause: variables[i].negOccList) {
+                        if (clause->literals.size() == minClauseLength) {
+                            negMinCounts[i] += 1;
+                        }
+                    }
+
+                    for (Cl* clause: variables[i].posOccList) {
+                        if (clause->literals.size() == minClauseLength) {
+                            posMinCounts[i] += 1;
+                        }
+                    }
+                }
+            });
+        }
+
         void findMinClauseLength() {
+            //the root propagation can satisfy all clauses, this is handled like all clauses being satisfied during the search
+            if (clauses.empty()) {
+                minClauseLength = 0;
+                nrMinClauses = 1;
+                return;
+            }
+
             //determine the length of the shortest clause
             minClauseLength = clauses[0].literals.size();
 
@@ -249,65 +628,238 @@ class MomsFreeman: public Heuristic {
             }
         }
 
-        void setPredictedAssignment(Var var) {
+        //sets the counters and the heuristic value of the variable from the precomputed values
+        void restoreHeuristicValue(const Var& variable, const InitialScores* initialScores) {
+            unsigned int posCount = 0;
+            unsigned int negCount = 0;
+
+            if (variable.id <= initialScores->momsNegCounts.size()) {
+                negCount = initialScores->momsNegCounts[variable.id - 1];
+                posCount = initialScores->momsPosCounts[variable.id - 1];
+            }
+
+            setHeuristicValue(variable, posCount, negCount);
+        }
+
+        void setPredictedAssignment(const Var& var) {
             if (posCounts[var.id - 1] >= negCounts[var.id - 1]) {
-                predictedAssignments.push_back(Assignment::TRUE);
+                predictedAssignments[var.id - 1] = Assignment::TRUE;
+            } else {
+                predictedAssignments[var.id - 1] = Assignment::FALSE;
+            }
+        }
+
+        //counts the clauses by their length, only needed for the dynamic heuristic
+        void buildLengthBuckets() {
+            std::size_t nrVariables = variables.size();
+
+            //sort the clauses by their length
+            std::vector<std::size_t> clausesByLength(clauses.size());
+
+            for (const Cl& clause: clauses) {
+                if (clause.literals.size() >= nrClausesOfLength.size()) {
+                    nrClausesOfLength.resize(clause.literals.size() + 1, 0);
+                }
+                nrClausesOfLength[clause.literals.size()] += 1;
+            }
+
+            std::vector<std::size_t> lengthStarts(nrClausesOfLength.size() + 1, 0);
+            for (std::size_t length = 0; length < nrClausesOfLength.size(); length++) {
+                lengthStarts[length + 1] = lengthStarts[length] + nrClausesOfLength[length];
+            }
+
+            std::vector<std::size_t> positions(lengthStarts.begin(), lengthStarts.end() - 1);
+            for (std::size_t i = 0; i < clauses.size(); i++) {
+                clausesByLength[positions[clauses[i].literals.size()]++] = i;
+            }
+
+            //count the distinct lengths of every variable, every variable has an entry for length 0
+            std::vector<unsigned int> lastLength(nrVariables, 0);
+            std::vector<std::size_t> nrLengths(nrVariables, 1);
+
+            for (std::size_t i: clausesByLength) {
+                unsigned int length = clauses[i].literals.size();
+
+                for (Lit lit: clauses[i].literals) {
+                    if (lastLength[lit.id - 1] != length) {
+                        lastLength[lit.id - 1] = length;
+                        nrLengths[lit.id - 1] += 1;
+                    }
+                }
+            }
+
+            lengthOffsets.resize(nrVariables + 1, 0);
+            for (std::size_t i = 0; i < nrVariables; i++) {
+                lengthOffsets[i + 1] = lengthOffsets[i] + nrLengths[i];
+            }
+
+            occurenceLengths.resize(lengthOffsets.back(), 0);
+            posLengthCounts.resize(lengthOffsets.back(), 0);
+            negLengthCounts.resize(lengthOffsets.back(), 0);
+
+            //assign the slots in the order of the lengths, so that the lengths of every variable are sorted
+            std::vector<std::size_t> currentSlot(lengthOffsets.begin(), lengthOffsets.end() - 1);
+            std::fill(lastLength.begin(), lastLength.end(), 0);
+
+            clauseSlotOffsets.resize(clauses.size() + 1, 0);
+            for (std::size_t i = 0; i < clauses.size(); i++) {
+                clauseSlotOffsets[i + 1] = clauseSlotOffsets[i] + clauses[i].literals.size();
+            }
+            literalSlots.resize(clauseSlotOffsets.back());
+
+            for (std::size_t i: clausesByLength) {
+                unsigned int length = clauses[i].literals.size();
+
+                for (std::size_t j = 0; j < length; j++) {
+                    Lit lit = clauses[i].literals[j];
+
+                    if (lastLength[lit.id - 1] != length) {
+                        lastLength[lit.id - 1] = length;
+                        currentSlot[lit.id - 1] += 1;
+                        occurenceLengths[currentSlot[lit.id - 1]] = length;
+                    }
+
+                    std::size_t slot = currentSlot[lit.id - 1];
+                    literalSlots[clauseSlotOffsets[i] + j] = slot;
+
+                    if (lit.negative) {
+                        negLengthCounts[slot] += 1;
+                    } else {
+                        posLengthCounts[slot] += 1;
+                    }
+                }
+            }
+        }
+
+        //position of the counters of the variable for the given clause length, returns the end of the range if the variable has no such occurence
+        std::size_t lengthIndex(unsigned int varId, unsigned int length) const {
+            auto begin = occurenceLengths.begin() + lengthOffsets[varId - 1];
+            auto end = occurenceLengths.begin() + lengthOffsets[varId];
+            auto it = std::lower_bound(begin, end, length);
+
+            if (it == end || *it != length) {
+                return lengthOffsets.back();
+            }
+
+            return it - occurenceLengths.begin();
+        }
+
+        unsigned int lengthCount(const std::vector<unsigned int>& lengthCounts, unsigned int varId, unsigned int length) const {
+            std::size_t index = lengthIndex(varId, length);
+            return index == lengthOffsets.back() ? 0 : lengthCounts[index];
+        }
+
+        //moves the clause from its length to length 0 as it is satisfied
+        void removeFromLengthBuckets(Cl* clause) {
+            std::size_t clauseIndex = clause - clauses.data();
+
+            nrClausesOfLength[clause->literals.size()] -= 1;
+            nrClausesOfLength[0] += 1;
+
+            for (std::size_t j = 0; j < clause->literals.size(); j++) {
+                Lit lit = clause->literals[j];
+                std::vector<unsigned int>& lengthCounts = lit.negative ? negLengthCounts : posLengthCounts;
+
+                lengthCounts[literalSlots[clauseSlotOffsets[clauseIndex] + j]] -= 1;
+                lengthCounts[lengthOffsets[lit.id - 1]] += 1;
+            }
+        }
+
+        //same result as findMinClauseLength() but uses the clause counts instead of iterating over the clauses
+        void nextMinClauseLengthFromBuckets() {
+            while (nextMinClauseLength < nrClausesOfLength.size() && nrClausesOfLength[nextMinClauseLength] == 0) {
+                nextMinClauseLength += 1;
+            }
+
+            if (nextMinClauseLength < nrClausesOfLength.size()) {
+                minClauseLength = nextMinClauseLength;
+                nrMinClauses = nrClausesOfLength[nextMinClauseLength];
             } else {
-                predictedAssignments.push_back(Assignment::FALSE);
+                //all clauses are satisfied
+                minClauseLength = 0;
+                nrMinClauses = 1;
             }
         }
 
         public:
-            explicit MomsFreeman(std::vector<Var> variables, std::vector<Cl>& clauses, bool dynamic, double parameter) : Heuristic(variables, dynamic), clauses(clauses) {
+            explicit MomsFreeman(const std::vector<Var>& variables, std::vector<Cl>& clauses, double parameter, const InitialScores* initialScores = nullptr, unsigned int nrThreads = 1) : Heuristic(variables, !Dynamic), clauses(clauses) {
                 momsParameter = std::pow(2, parameter);
                 
-                findMinClauseLength();
+                if (initialScores != nullptr) {
+                    minClauseLength = initialScores->minClauseLength;
+                    nrMinClauses = initialScores->nrMinClauses;
+                } else {
+                    findMinClauseLength();
+                }
+
+                if constexpr (Dynamic) {
+                    buildLengthBuckets();
+                }
                 
-                for (Var var: variables) {
-                    calculateHeuristicValue(var);
+                posCounts.assign(variables.size(), 0);
+                negCounts.assign(variables.size(), 0);
+
+                std::vector<unsigned int> posMinCounts;
+                std::vector<unsigned int> negMinCounts;
+
+                if (initialScores == nullptr) {
+                    countMinClauses(variables, nrThreads, posMinCounts, negMinCounts);
+                }
+
+                for (std::size_t i = 0; i < variables.size(); i++) {
+                    const Var& var = variables[i];
+
+                    if (initialScores != nullptr) {
+                        restoreHeuristicValue(var, initialScores);
+                    } else {
+                        setHeuristicValue(var, posMinCounts[i], negMinCounts[i]);
+                    }
                     setPredictedAssignment(var);
                     activeVariables[var.id] = true;
-                    variablesHeap.insert(var);
+                    addVariable(var);
                     //std::cout << "Id: " << var.id << ", heuristics value: " << heuristicValues[var.id] << std::endl;
                 }
+
+                sortOrder();
+            }
+
+            template<class Setup>
+            static MomsFreeman* create(std::vector<Var>& variables, std::vector<Cl>& clauses, const Setup& setup, const InitialScores* initialScores) {
+                return new MomsFreeman(variables, clauses, setup.momsParameter, initialScores, setup.initThreads);
             }
 
             void updateVariables(Cl* clause) {
                 //is only executed if the heuristic is dynamic
-                if (!dynamicHeuristic) {
+                if constexpr (!Dynamic) {
                     return;
                 }
 
                 if ((clause->literals.size() == minClauseLength)) {
                     nrMinClauses -= 1;
 
+                    const std::size_t* slots = literalSlots.data() + clauseSlotOffsets[clause - clauses.data()];
+
                     for (Lit lit: clause->literals) {
-                        Var& var = variables.at(lit.id - 1);
+                        const Var& var = variables.at(lit.id - 1);
+                        std::size_t slot = *slots++;
 
                         //update the heuristic value of all variables in the clause that are still in the heap
                         if (activeVariables[var.id]) {
-                            std::vector<Cl*> occList;
+                            //number of unsatisfied minimum clauses with the opposite literal
+                            unsigned int count;
 
                             if (lit.negative) {
-                                occList = var.posOccList;
+                                count = posLengthCounts[slot];
                                 //update the counter for the assginment prediction
                                 negCounts[var.id - 1] -= 1;
                             } else {
-                                occList = var.negOccList;
+                                count = negLengthCounts[slot];
                                 posCounts[var.id - 1] -= 1;
                             }
 
-                            unsigned int count = 0;
-
-                            for (Cl* clause: occList) {
-                                if (clause->literals.size() == minClauseLength) {
-                                    count += 1;
-                                }
-                            }
-
+                            //the value grows if the opposite literal occurs in more than momsParameter minimum clauses
                             heuristicValues[var.id] -= momsParameter - count; 
-
-                            variablesHeap.increase(var);
+                            markDirty(var.id, count > momsParameter);
 
                             //update the assignment prediction
                             setPredictedAssignment(var);
@@ -317,6 +869,9 @@ class MomsFreeman: public Heuristic {
                     }
                 }
 
+                if (clause->literals.size() > 0) {
+                    removeFromLengthBuckets(clause);
+                }
 
                 //std::cout << "minClauseOccs: " << nrMinClauses << std::endl;
 
@@ -325,80 +880,124 @@ class MomsFreeman: public Heuristic {
                     //clear the clause so that it won't count as minimum clause as it is already satisfied
                     clause->literals.clear();
 
-                    findMinClauseLength();
+                    nextMinClauseLengthFromBuckets();
 
                     variablesHeap.clear();
-                    predictedAssignments.clear();
-                    posCounts.clear();
-                    negCounts.clear();
+                    clearDirty();
 
-                    for (Var var: variables) {
+                    //the counts and predictions of the variables that were already assigned are not read anymore
+                    for (const Var& var: variables) {
                         if (activeVariables[var.id]) {
-                            calculateHeuristicValue(var);
-                            variablesHeap.insert(var);
-                        }   
+                            setHeuristicValue(var, lengthCount(posLengthCounts, var.id, minClauseLength), lengthCount(negLengthCounts, var.id, minClauseLength));
+                            setPredictedAssignment(var);
+                            variablesHeap.insert(Var(var.id));
+                        }
                     }
                 }
             }
 };
 
+template<bool Dynamic>
 class HybridHeuristic: public Heuristic {
     private:
         std::vector<double> negHeuristicValues;
         std::vector<double> posHeuristicValues;
         unsigned int lengthCutoff;
+        bool fixedPoint;
+        std::vector<FixedPoint::Score> negFixedPointValues;
+        std::vector<FixedPoint::Score> posFixedPointValues;
 
-    public:
-        explicit HybridHeuristic(std::vector<Var> variables_, bool dynamic, unsigned int lengthCutoff) : Heuristic(variables_, dynamic), lengthCutoff(lengthCutoff) {
-            for (Var var: variables_) {
-                double negHeuristicValue = 0;
-                double posHeuristicValue = 0;
+        void initFixedPoint(const std::vector<Var>& variables_, std::size_t lengthCutoff, unsigned int nrThreads) {
+            compareFixedPoint = true;
 
-                //std::cout << "neg size: " << var.negOccList.size() << ", pos size: " << var.posOccList.size() << std::endl;
+            sumWeights(variables_, lengthCutoff, nrThreads, FixedPoint::weight, negFixedPointValues, posFixedPointValues);
 
-                for (Cl* clause: var.negOccList) {
-                    if (clause->literals.size() > 0 && clause->literals.size() <= lengthCutoff) {
-                        double clauseSize = static_cast<double>(clause->literals.size());
-                        negHeuristicValue += pow(2, -clauseSize);
-                    }
-                }
+            for (std::size_t i = 0; i < variables_.size(); i++) {
+                const Var& var = variables_[i];
+
+                fixedPointValues[var.id] = negFixedPointValues[i] + posFixedPointValues[i];
+                activeVariables[var.id] = true;
+                addVariable(var);
+
+                predictedAssignments[var.id - 1] = posFixedPointValues[i] >= negFixedPointValues[i] ? Assignment::TRUE : Assignment::FALSE;
+            }
 
-                negHeuristicValues.push_back(negHeuristicValue);
+            sortOrder();
+        }
+
+        void updateFixedPoint(Cl* clause) {
+            FixedPoint::Score updateValue = FixedPoint::weight(clause->literals.size());
+
+            for (Lit lit: clause->literals) {
+                if (activeVariables[lit.id]) {
+                    fixedPointValues[lit.id] -= updateValue;
 
-                for (Cl* clause: var.posOccList) {
-                    if (clause->literals.size() > 0 && clause->literals.size() <= lengthCutoff) {
-                        double clauseSize = static_cast<double>(clause->literals.size());
-                        posHeuristicValue += pow(2, -clauseSize);
+                    markDirty(lit.id);
+
+                    if (lit.negative) {
+                        negFixedPointValues[lit.id - 1] -= updateValue;
+                    } else {
+                        posFixedPointValues[lit.id - 1] -= updateValue;
+                    }
+
+                    if (posFixedPointValues[lit.id - 1] >= negFixedPointValues[lit.id - 1]) {
+                        predictedAssignments[lit.id - 1] = Assignment::TRUE;
+                    } else {
+                        predictedAssignments[lit.id - 1] = Assignment::FALSE;
                     }
                 }
+            }
+        }
 
-                posHeuristicValues.push_back(posHeuristicValue);
+    public:
+        explicit HybridHeuristic(const std::vector<Var>& variables_, unsigned int lengthCutoff, bool fixedPoint = false, unsigned int nrThreads = 1) : Heuristic(variables_, !Dynamic), lengthCutoff(lengthCutoff), fixedPoint(fixedPoint) {
+            if (fixedPoint) {
+                initFixedPoint(variables_, lengthCutoff, nrThreads);
+                return;
+            }
 
-                //heuristicValues[var.id - 1] = heuristicValue;
-                heuristicValues[var.id] = negHeuristicValue + posHeuristicValue;
-                activeVariables[var.id] = true;
-                variablesHeap.insert(var);
+            sumWeights(variables_, lengthCutoff, nrThreads, jeroslowWangWeight, negHeuristicValues, posHeuristicValues);
 
-                //std::cout << "Var: " << var.id << ", heuristic value: " << heuristicValue << std::endl;
+            for (std::size_t i = 0; i < variables_.size(); i++) {
+                const Var& var = variables_[i];
+
+                heuristicValues[var.id] = negHeuristicValues[i] + posHeuristicValues[i];
+                activeVariables[var.id] = true;
+                addVariable(var);
 
                 //use the positive and negative heuristic values to predict the assignment
-                if (posHeuristicValue >= negHeuristicValue) {
-                    predictedAssignments.push_back(Assignment::TRUE);
+                if (posHeuristicValues[i] >= negHeuristicValues[i]) {
+                    predictedAssignments[var.id - 1] = Assignment::TRUE;
                 } else {
-                    predictedAssignments.push_back(Assignment::FALSE);
+                    predictedAssignments[var.id - 1] = Assignment::FALSE;
                 }
-
             }
+
+            sortOrder();
+        }
+
+        template<class Setup>
+        static HybridHeuristic* create(std::vector<Var>& variables, std::vector<Cl>& /*clauses*/, const Setup& setup, const InitialScores* /*initialScores*/) {
+            return new HybridHeuristic(variables, setup.hybridHeuristicParam, setup.fixedPointScores, setup.initThreads);
         }
 
         void updateVariables(Cl* clause) {
-            if (!dynamicHeuristic || clause->literals.size() > lengthCutoff) {
+            if constexpr (!Dynamic) {
+                return;
+            }
+
+            if (clause->literals.size() > lengthCutoff) {
+                return;
+            }
+
+            if (fixedPoint) {
+                updateFixedPoint(clause);
                 return;
             }
 
             //update all variables in the clause
             for (Lit lit: clause->literals) {
-                Var& var = variables.at(lit.id - 1);
+                const Var& var = variables.at(lit.id - 1);
 
                 //std::cout << "Update variable: " << var.id << std::endl;
                 //remove the variable from the set and reinsert it to update the position
@@ -408,7 +1007,7 @@ class HybridHeuristic: public Heuristic {
                     
                     heuristicValues[var.id] -= updateValue;
 
-                    variablesHeap.increase(var);
+                    markDirty(var.id);
 
                     //update assignment prediction
                     if (lit.negative) {
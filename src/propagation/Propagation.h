@@ -3,38 +3,136 @@
 
 #include <deque>
 #include <unordered_set>
+#include <algorithm>
+#include <stdexcept>
 
 
 #include "SATTypes.h"
 #include "Heuristics.h"
 
 namespace Propagation {
+
+    //propagates the unit clauses of the formula and their consequences before the first decision. Satisfied clauses are removed
+    //and the false literals are removed from the remaining clauses. Returns the assigned literals in the order of the propagation
+    inline std::vector<Lit> propagateRoot(std::vector<Cl>& clauses, unsigned int nrVariables) {
+        //occurence lists of the literals, the positive literal of variable v has the index 2 * (v - 1), the negative one 2 * (v - 1) + 1
+        std::vector<std::size_t> offsets(2 * nrVariables + 1, 0);
+        for (const Cl& clause: clauses) {
+            for (Lit lit: clause.literals) {
+                offsets.at(2 * (lit.id - 1) + lit.negative + 1) += 1;
+            }
+        }
+
+        for (std::size_t i = 1; i < offsets.size(); i++) {
+            offsets[i] += offsets[i - 1];
+        }
+
+        std::vector<std::size_t> occurences(offsets.back());
+        std::vector<std::size_t> positions(offsets.begin(), offsets.end() - 1);
+        for (std::size_t i = 0; i < clauses.size(); i++) {
+            for (Lit lit: clauses[i].literals) {
+                occurences[positions[2 * (lit.id - 1) + lit.negative]++] = i;
+            }
+        }
+
+        std::vector<Assignment> values(nrVariables, Assignment::OPEN);
+        std::vector<unsigned int> nrOpenLiterals(clauses.size());
+        std::vector<bool> satisfied(clauses.size(), false);
+        std::vector<Lit> trail;
+
+        auto isTrue = [&](Lit lit) {
+            return values[lit.id - 1] == (lit.negative ? Assignment::FALSE : Assignment::TRUE);
+        };
+
+        //assigns the literal, returns false if the opposite literal is already assigned
+        auto assign = [&](Lit lit) {
+            if (values[lit.id - 1] == Assignment::OPEN) {
+                values[lit.id - 1] = lit.negative ? Assignment::FALSE : Assignment::TRUE;
+                trail.push_back(lit);
+            }
+
+            return isTrue(lit);
+        };
+
+        for (std::size_t i = 0; i < clauses.size(); i++) {
+            nrOpenLiterals[i] = clauses[i].literals.size();
+
+            if (clauses[i].literals.size() == 1 && !assign(clauses[i].literals[0])) {
+                throw std::runtime_error("The formula is unsatisfiable, it contains contradicting unit clauses.");
+            }
+        }
+
+        for (std::size_t head = 0; head < trail.size(); head++) {
+            Lit lit = trail[head];
+            std::size_t trueIndex = 2 * (lit.id - 1) + lit.negative;
+            std::size_t falseIndex = 2 * (lit.id - 1) + !lit.negative;
+
+            for (std::size_t j = offsets[trueIndex]; j < offsets[trueIndex + 1]; j++) {
+                satisfied[occurences[j]] = true;
+            }
+
+            for (std::size_t j = offsets[falseIndex]; j < offsets[falseIndex + 1]; j++) {
+                std::size_t clauseIndex = occurences[j];
+                nrOpenLiterals[clauseIndex] -= 1;
+
+                if (satisfied[clauseIndex] || nrOpenLiterals[clauseIndex] > 1) {
+                    continue;
+                }
+
+                //the clause is unit or all its literals are assigned, a true literal that is not propagated yet satisfies it later
+                const std::vector<Lit>& literals = clauses[clauseIndex].literals;
+                if (std::any_of(literals.begin(), literals.end(), isTrue)) {
+                    continue;
+                }
+
+                auto open = std::find_if(literals.begin(), literals.end(), [&](Lit literal) { return values[literal.id - 1] == Assignment::OPEN; });
+                if (open == literals.end()) {
+                    throw std::runtime_error("The formula is unsatisfiable, the unit propagation before the first decision leads to a conflict.");
+                }
+
+                assign(*open);
+            }
+        }
+
+        std::vector<Cl> simplified;
+        simplified.reserve(clauses.size());
+
+        for (std::size_t i = 0; i < clauses.size(); i++) {
+            if (satisfied[i]) {
+                continue;
+            }
+
+            Cl clause;
+            for (Lit lit: clauses[i].literals) {
+                if (values[lit.id - 1] == Assignment::OPEN) {
+                    clause.addLiteral(lit);
+                }
+            }
+            simplified.push_back(std::move(clause));
+        }
+
+        clauses = std::move(simplified);
+
+        return trail;
+    }
     
-    void propagate(std::vector<Cl>& clauses, std::vector<Var>& variables, std::vector<unsigned int>& trail, int& head, Heuristic* heuristic, std::vector<Assignment>& values) {
+    //the heuristic is a template parameter, so the updates of the heuristic are inlined into the propagation
+    template<class HeuristicType>
+    void propagate(std::vector<Cl>& /*clauses*/, std::vector<Var>& variables, std::vector<unsigned int>& trail, int& head, HeuristicType* heuristic, std::vector<Assignment>& values) {
         while (head < trail.size()) {
             unsigned int varId = trail[head];
             head++;
 
-            //choose the right occurence list
-            std::vector<Cl*> occList;
-            std::vector<Cl*> satOccList;
+            const Var& var = variables[varId - 1];
 
-            Var var = variables[varId - 1];
-
-            if(values[varId - 1] == TRUE) {
-                occList = var.negOccList;
-                satOccList = var.posOccList;
-            } else if (values[varId - 1] == FALSE) {
-                occList = var.posOccList;
-                satOccList = var.negOccList;
-            } else {
+            if (values[varId - 1] == Assignment::OPEN) {
                 throw std::runtime_error("Variable that is propagated has on value assigned.");
             }
 
-            //std::cout << "Propagated variable: " << var.id << ", state: " << values[var.id - 1] << std::endl;
-            //std::cout << "occList size: " << occList.size() << ", satOccList size: " << satOccList.size() << std::endl;
+            //choose the right lists, the lists are only read so they are not copied
+            const std::vector<Implication>& implications = values[varId - 1] == TRUE ? var.negImplications : var.posImplications;
+            const std::vector<Cl*>& satOccList = values[varId - 1] == TRUE ? var.posOccList : var.negOccList;
 
-            int i = 1;
             //iterate over the clauses that are satisfied and clear them and update the counters and the heuristic
             for (Cl* clause: satOccList) {
                 heuristic->updateVariables(clause);
@@ -42,11 +140,22 @@ namespace Propagation {
                 clause->literals.clear();
             }
 
-            i = 1;
+            //iterate over the clauses that contain the false literal in the order of the occurence list, so the trail is the same
+            //as without the implication lists
+            for (Implication implication: implications) {
+                //a binary clause is unit if its other literal is open, otherwise it is satisfied or assigned already
+                if (implication.isBinary()) {
+                    Lit lit = implication.implied();
+
+                    if (values[lit.id - 1] == Assignment::OPEN) {
+                        values[lit.id - 1] = lit.negative ? Assignment::FALSE : Assignment::TRUE;
+                        trail.push_back(lit.id);
+                    }
+                    continue;
+                }
+
+                Cl* clause = implication.clause();
 
-            //iterate over occurence list and update counters
-            for (Cl* clause: occList) {
-                //std::cout << "occ list: " << i++ << std::endl;
                 //check if the clause is already satisfied
                 if (clause->literals.size() == 0) {
                     continue;
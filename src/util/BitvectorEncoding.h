@@ -16,14 +16,11 @@ namespace BitvectorEncoding {
         return output;
     }
 
-    std::vector<uint32_t> diffEncoding(std::vector<bool> bitvetor) {
-        //add a false to the bitvector to make it possible to differntiate between the different sectors of the compressed file
-        bitvetor.push_back(false);
-
-        std::vector<uint32_t> output;
+    //appends the distances between the false values of the bitvector to the output
+    void diffEncoding(const std::vector<bool>& bitvector, std::vector<uint32_t>& output) {
         uint32_t currentDistance = 0;
 
-        for (bool value: bitvetor) {
+        for (bool value: bitvector) {
             if (value) {
                 currentDistance += 1;
             } else {
@@ -32,6 +29,14 @@ namespace BitvectorEncoding {
             }
         }
 
+        //the bitvector ends with an implicit false to make it possible to differntiate between the different sectors of the compressed file
+        output.push_back(currentDistance);
+    }
+
+    std::vector<uint32_t> diffEncoding(const std::vector<bool>& bitvector) {
+        std::vector<uint32_t> output;
+        diffEncoding(bitvector, output);
+
         return output;
     }
 }
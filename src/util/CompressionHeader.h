@@ -0,0 +1,103 @@
+#ifndef SRC_UTIL_COMPRESSIONHEADER_H
+#define SRC_UTIL_COMPRESSIONHEADER_H
+
+#include <string>
+#include <cstring>
+#include <stdexcept>
+
+//header that is written in front of every compressed model. It identifies the formula the model was compressed with.
+//Version 2 additionally stores the flags of the optional modes, it is only written if a flag is set so that
+//models that are compressed without these modes stay identical to version 1
+struct CompressionHeader {
+    static constexpr const char* MAGIC = "PMC";
+    static constexpr uint8_t VERSION = 1;
+    static constexpr uint8_t FLAGS_VERSION = 2;
+    //size of the smallest header, the header of version 2 has additional bytes for the flags
+    static constexpr std::size_t SIZE = 12;
+    static constexpr std::size_t FLAGS_SIZE = 16;
+
+    //the formula was preprocessed before the compression
+    static constexpr uint32_t PREPROCESSED = 1;
+    //the unit clauses were propagated before the first decision, the assigned variables are not part of the compressed model
+    static constexpr uint32_t ROOT_PROPAGATION = 2;
+    //equivalent literals were substituted by a representative, the substituted variables are not part of the compressed model
+    static constexpr uint32_t EQUIVALENT_LITERALS = 4;
+    //every connected component of the formula was compressed separately, a table of the compressed components follows the header
+    static constexpr uint32_t COMPONENTS = 8;
+    //the variables and clauses were renumbered in a Cuthill-McKee order, the model is mapped back to the original ids when it is written
+    static constexpr uint32_t RENUMBERED = 16;
+    //the models of an instance were predicted from the values of a reference model, the hash of the compressed reference follows the header
+    static constexpr uint32_t REFERENCE = 32;
+    //the models were predicted from the trained polarity priors of the formula, the hash of the priors file follows the header and the hash of the reference
+    static constexpr uint32_t PRIORS = 64;
+    //every model was compressed with a portfolio of heuristics, the id of the heuristic of the smallest result follows the hashes
+    static constexpr uint32_t HEURISTIC = 128;
+    //every encoded stream was compressed with all codecs and the smallest result was kept, the id of its codec is the first byte of the stream
+    static constexpr uint32_t CODEC = 256;
+    //the Jeroslow-Wang and hybrid heuristics used exact fixed-point scores instead of floating point values
+    static constexpr uint32_t FIXED_POINT_SCORES = 512;
+    //the flags of the modes that change the clauses of the prepared formula, only these identify a variant of the formula
+    static constexpr uint32_t FORMULA_FLAGS = PREPROCESSED | ROOT_PROPAGATION | EQUIVALENT_LITERALS | RENUMBERED;
+
+    uint64_t formulaFingerprint;
+    uint32_t flags;
+
+    explicit CompressionHeader(uint64_t formulaFingerprint = 0, uint32_t flags = 0) : formulaFingerprint(formulaFingerprint), flags(flags) {}
+
+    bool hasFlag(uint32_t flag) const {
+        return (flags & flag) != 0;
+    }
+
+    std::size_t size() const {
+        return flags == 0 ? SIZE : FLAGS_SIZE;
+    }
+
+    std::string serialize() const {
+        std::string output(MAGIC, 3);
+        output.push_back(static_cast<char>(flags == 0 ? VERSION : FLAGS_VERSION));
+        output.append(reinterpret_cast<const char*>(&formulaFingerprint), sizeof(formulaFingerprint));
+
+        if (flags != 0) {
+            output.append(reinterpret_cast<const char*>(&flags), sizeof(flags));
+        }
+
+        return output;
+    }
+
+    //size of the header that starts with the given bytes, at least the magic and the version must be given
+    static std::size_t sizeOf(const std::string& input) {
+        if (input.size() < 4 || input.compare(0, 3, MAGIC) != 0) {
+            throw std::runtime_error("The file is not a compressed model or was created by an older version.");
+        }
+
+        uint8_t version = static_cast<uint8_t>(input[3]);
+
+        if (version == VERSION) {
+            return SIZE;
+        } else if (version == FLAGS_VERSION) {
+            return FLAGS_SIZE;
+        }
+
+        throw std::runtime_error("Unsupported version of the compressed model: " + std::to_string(version));
+    }
+
+    //reads the header from the beginning of the compressed file
+    static CompressionHeader parse(const std::string& input) {
+        std::size_t size = sizeOf(input);
+
+        if (input.size() < size) {
+            throw std::runtime_error("The file is not a compressed model or was created by an older version.");
+        }
+
+        CompressionHeader header;
+        std::memcpy(&header.formulaFingerprint, input.data() + 4, sizeof(header.formulaFingerprint));
+
+        if (size == FLAGS_SIZE) {
+            std::memcpy(&header.flags, input.data() + SIZE, sizeof(header.flags));
+        }
+
+        return header;
+    }
+};
+
+#endif
@@ -0,0 +1,181 @@
+#ifndef SRC_UTIL_HASH_H
+#define SRC_UTIL_HASH_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+//implementation of the 64 bit xxHash algorithm (XXH64), can be used in one shot or as a streaming hash
+namespace Hash {
+
+    constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+    constexpr uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+    constexpr uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+    inline uint64_t rotateLeft(uint64_t value, unsigned int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    inline uint64_t read64(const char* data) {
+        uint64_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    inline uint32_t read32(const char* data) {
+        uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    inline uint64_t round(uint64_t accumulator, uint64_t input) {
+        accumulator += input * PRIME2;
+        accumulator = rotateLeft(accumulator, 31);
+        return accumulator * PRIME1;
+    }
+
+    inline uint64_t mergeRound(uint64_t accumulator, uint64_t value) {
+        accumulator ^= round(0, value);
+        return accumulator * PRIME1 + PRIME4;
+    }
+
+    class XXH64 {
+        private:
+            uint64_t v1;
+            uint64_t v2;
+            uint64_t v3;
+            uint64_t v4;
+            uint64_t seed;
+            uint64_t totalLength;
+            char buffer[32];
+            unsigned int bufferSize;
+
+            void consumeStripe(const char* data) {
+                v1 = round(v1, read64(data));
+                v2 = round(v2, read64(data + 8));
+                v3 = round(v3, read64(data + 16));
+                v4 = round(v4, read64(data + 24));
+            }
+
+        public:
+            explicit XXH64(uint64_t seed = 0) : seed(seed) {
+                reset();
+            }
+
+            void reset() {
+                v1 = seed + PRIME1 + PRIME2;
+                v2 = seed + PRIME2;
+                v3 = seed;
+                v4 = seed - PRIME1;
+                totalLength = 0;
+                bufferSize = 0;
+            }
+
+            void update(const char* data, std::size_t length) {
+                totalLength += length;
+
+                //fill up the buffered stripe first
+                if (bufferSize > 0) {
+                    std::size_t missing = std::min<std::size_t>(32 - bufferSize, length);
+                    std::memcpy(buffer + bufferSize, data, missing);
+                    bufferSize += missing;
+                    data += missing;
+                    length -= missing;
+
+                    if (bufferSize < 32) {
+                        return;
+                    }
+
+                    consumeStripe(buffer);
+                    bufferSize = 0;
+                }
+
+                while (length >= 32) {
+                    consumeStripe(data);
+                    data += 32;
+                    length -= 32;
+                }
+
+                std::memcpy(buffer, data, length);
+                bufferSize = length;
+            }
+
+            template<typename T>
+            void updateValue(T value) {
+                update(reinterpret_cast<const char*>(&value), sizeof(T));
+            }
+
+            uint64_t digest() const {
+                uint64_t hash;
+
+                if (totalLength >= 32) {
+                    hash = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+                    hash = mergeRound(hash, v1);
+                    hash = mergeRound(hash, v2);
+                    hash = mergeRound(hash, v3);
+                    hash = mergeRound(hash, v4);
+                } else {
+                    hash = seed + PRIME5;
+                }
+
+                hash += totalLength;
+
+                //process the remaining bytes in the buffer
+                const char* data = buffer;
+                unsigned int remaining = bufferSize;
+
+                while (remaining >= 8) {
+                    hash ^= round(0, read64(data));
+                    hash = rotateLeft(hash, 27) * PRIME1 + PRIME4;
+                    data += 8;
+                    remaining -= 8;
+                }
+
+                if (remaining >= 4) {
+                    hash ^= static_cast<uint64_t>(read32(data)) * PRIME1;
+                    hash = rotateLeft(hash, 23) * PRIME2 + PRIME3;
+                    data += 4;
+                    remaining -= 4;
+                }
+
+                while (remaining > 0) {
+                    hash ^= static_cast<uint64_t>(static_cast<uint8_t>(*data)) * PRIME5;
+                    hash = rotateLeft(hash, 11) * PRIME1;
+                    data += 1;
+                    remaining -= 1;
+                }
+
+                //final avalanche
+                hash ^= hash >> 33;
+                hash *= PRIME2;
+                hash ^= hash >> 29;
+                hash *= PRIME3;
+                hash ^= hash >> 32;
+
+                return hash;
+            }
+    };
+
+    inline uint64_t xxh64(const char* data, std::size_t length, uint64_t seed = 0) {
+        XXH64 hasher(seed);
+        hasher.update(data, length);
+        return hasher.digest();
+    }
+
+    inline std::string toHex(uint64_t hash) {
+        const char* digits = "0123456789abcdef";
+        std::string output(16, '0');
+
+        for (int i = 15; i >= 0; i--) {
+            output[i] = digits[hash & 0xF];
+            hash >>= 4;
+        }
+
+        return output;
+    }
+}
+
+#endif
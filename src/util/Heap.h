@@ -21,6 +21,9 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef Minisat_Heap_h
 #define Minisat_Heap_h
 
+#include <vector>
+#include <algorithm>
+
 #include "Vec.h"
 #include "IntMap.h"
 
@@ -35,6 +38,7 @@ class Heap {
     vec<K>                heap;     // Heap of Keys
     IntMap<K,int,MkIndex> indices;  // Each Key's position (index) in the Heap
     Comp                  lt;       // The heap is a minimum-heap with respect to this comparator
+    std::vector<bool>     collected;// Positions that are already collected by updateAll, always false outside of it
 
     // Index "traversal" functions
     static inline int left  (int i) { return i*2+1; }
@@ -96,6 +100,38 @@ class Heap {
     }
 
 
+    // Restore the heap property after the keys of several elements were changed. The changed positions and the paths from the
+    // decreased elements to the root are percolated down, deepest position first, like the bottom-up construction of the heap.
+    // The other subheaps do not contain a decreased key, so their roots are still not larger than any of their keys and they
+    // are valid as soon as their increased elements are percolated down. The paths are collected first and end at the first
+    // position that was already collected, every ancestor of a collected path position has been collected as well:
+    void updateAll(const std::vector<K>& increased, const std::vector<K>& decreased)
+    {
+        if (collected.size() < (std::size_t)heap.size())
+            collected.resize(heap.size(), false);
+
+        std::vector<int> positions;
+
+        for (const K& k : decreased)
+            if (inHeap(k))
+                for (int i = indices[k]; !collected[i]; i = parent(i)){
+                    collected[i] = true;
+                    positions.push_back(i);
+                    if (i == 0) break; }
+
+        for (const K& k : increased)
+            if (inHeap(k) && !collected[indices[k]]){
+                collected[indices[k]] = true;
+                positions.push_back(indices[k]); }
+
+        std::sort(positions.begin(), positions.end(), [](int a, int b) { return a > b; });
+
+        for (int position : positions){
+            collected[position] = false;
+            percolateDown(position); }
+    }
+
+
     void insert(K k)
     {
         indices.reserve(k, -1);
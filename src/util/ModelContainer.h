@@ -0,0 +1,250 @@
+#ifndef SRC_UTIL_MODELCONTAINER_H
+#define SRC_UTIL_MODELCONTAINER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <fstream>
+#include <cstring>
+#include <stdexcept>
+
+#include "CompressionHeader.h"
+#include "MappedFile.h"
+
+//container that stores all compressed models of one formula in a single file. The layout is
+//  header | model payloads | index | trailer
+//The header is the compression header that is shared by all models, the payloads are the compressed models without their header.
+//The index stores the name, the offset and the length of every payload and the trailer at the end of the file points to the index
+namespace ModelContainer {
+
+    constexpr const char* MAGIC = "PMCI";
+    constexpr uint32_t VERSION = 1;
+
+    struct Trailer {
+        uint64_t indexOffset;
+        uint64_t nrEntries;
+        char magic[4];
+        uint32_t version;
+    };
+
+    struct Entry {
+        std::string name;
+        uint64_t offset;
+        uint64_t length;
+    };
+
+    class Writer {
+        private:
+            std::string filename;
+            std::ofstream output;
+            std::unique_ptr<CompressionHeader> header;
+            std::vector<Entry> entries;
+            uint64_t position;
+            bool closed;
+
+        public:
+            explicit Writer(const std::string& filename) : filename(filename), output(filename, std::ios::binary), position(0), closed(false) {
+                if (!output) {
+                    throw std::runtime_error("Could not create the container: " + filename);
+                }
+            }
+
+            Writer(const Writer&) = delete;
+            Writer& operator=(const Writer&) = delete;
+
+            ~Writer() {
+                if (!closed) {
+                    close();
+                }
+            }
+
+            //appends a compressed model. All models of a container must be compressed with the same formula
+            void add(const std::string& name, const std::string& compressedModel) {
+                CompressionHeader modelHeader = CompressionHeader::parse(compressedModel);
+
+                //the header of the first model is used for the whole container
+                if (header == nullptr) {
+                    header = std::make_unique<CompressionHeader>(modelHeader);
+                    std::string serializedHeader = header->serialize();
+                    output.write(serializedHeader.data(), serializedHeader.size());
+                    position = serializedHeader.size();
+                } else if (header->formulaFingerprint != modelHeader.formulaFingerprint) {
+                    throw std::runtime_error("The model " + name + " was compressed with a different formula than the other models in " + filename);
+                } else if (header->flags != modelHeader.flags) {
+                    throw std::runtime_error("The model " + name + " was compressed with different modes than the other models in " + filename);
+                }
+
+                uint64_t length = compressedModel.size() - modelHeader.size();
+                output.write(compressedModel.data() + modelHeader.size(), length);
+
+                entries.push_back(Entry{name, position, length});
+                position += length;
+            }
+
+            //writes the index and the trailer
+            void close() {
+                closed = true;
+
+                if (header == nullptr) {
+                    std::string serializedHeader = CompressionHeader().serialize();
+                    output.write(serializedHeader.data(), serializedHeader.size());
+                    position = serializedHeader.size();
+                }
+
+                Trailer trailer;
+                trailer.indexOffset = position;
+                trailer.nrEntries = entries.size();
+                std::memcpy(trailer.magic, MAGIC, 4);
+                trailer.version = VERSION;
+
+                for (const Entry& entry: entries) {
+                    uint32_t nameLength = entry.name.size();
+                    output.write(reinterpret_cast<const char*>(&nameLength), sizeof(nameLength));
+                    output.write(entry.name.data(), nameLength);
+                    output.write(reinterpret_cast<const char*>(&entry.offset), sizeof(entry.offset));
+                    output.write(reinterpret_cast<const char*>(&entry.length), sizeof(entry.length));
+                }
+
+                output.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+                output.close();
+            }
+    };
+
+    class Reader {
+        private:
+            std::string filename;
+            std::ifstream input;
+            CompressionHeader header;
+            std::vector<Entry> entries;
+            std::map<std::string, std::size_t> entryIndices;
+            std::unique_ptr<MappedFile> mapping;
+
+            static bool readTrailer(std::ifstream& input, Trailer& trailer, uint64_t& size) {
+                input.seekg(0, std::ios::end);
+                std::streamoff end = input.tellg();
+
+                if (end < static_cast<std::streamoff>(CompressionHeader::SIZE + sizeof(Trailer))) {
+                    return false;
+                }
+
+                size = end;
+                input.seekg(end - sizeof(Trailer));
+                input.read(reinterpret_cast<char*>(&trailer), sizeof(trailer));
+
+                return input && std::memcmp(trailer.magic, MAGIC, 4) == 0;
+            }
+
+        public:
+            //reads the header and the index of the container. The trailer and the index are checked against the size of the file
+            //before anything is allocated for them, so a truncated or corrupted container throws an error
+            explicit Reader(const std::string& filename) : filename(filename), input(filename, std::ios::binary) {
+                Trailer trailer;
+                uint64_t size;
+                if (!input || !readTrailer(input, trailer, size)) {
+                    throw std::runtime_error("The file is not a model container: " + filename);
+                }
+
+                if (trailer.version != VERSION) {
+                    throw std::runtime_error("Unsupported version of the model container: " + std::to_string(trailer.version));
+                }
+
+                auto check = [&](bool valid, const std::string& what) {
+                    if (!valid) {
+                        throw std::runtime_error("The model container " + filename + " is corrupted: " + what + " out of range.");
+                    }
+                };
+
+                //the size of the header depends on its version
+                std::string serializedHeader(4, '\0');
+                input.seekg(0);
+                input.read(serializedHeader.data(), serializedHeader.size());
+                serializedHeader.resize(CompressionHeader::sizeOf(serializedHeader));
+                input.read(serializedHeader.data() + 4, serializedHeader.size() - 4);
+                header = CompressionHeader::parse(serializedHeader);
+
+                //the index lies between the payloads and the trailer, every entry has at least its name length, offset and length
+                uint64_t indexEnd = size - sizeof(Trailer);
+                constexpr uint64_t minEntrySize = sizeof(uint32_t) + 2 * sizeof(uint64_t);
+
+                check(trailer.indexOffset >= serializedHeader.size() && trailer.indexOffset <= indexEnd, "index offset");
+                check(trailer.nrEntries <= (indexEnd - trailer.indexOffset) / minEntrySize, "number of entries");
+
+                input.seekg(trailer.indexOffset);
+                entries.reserve(trailer.nrEntries);
+                uint64_t position = trailer.indexOffset;
+
+                for (uint64_t i = 0; i < trailer.nrEntries; i++) {
+                    Entry entry;
+                    uint32_t nameLength;
+                    input.read(reinterpret_cast<char*>(&nameLength), sizeof(nameLength));
+                    check(input && minEntrySize + nameLength <= indexEnd - position, "name length");
+
+                    entry.name.resize(nameLength);
+                    input.read(entry.name.data(), nameLength);
+                    input.read(reinterpret_cast<char*>(&entry.offset), sizeof(entry.offset));
+                    input.read(reinterpret_cast<char*>(&entry.length), sizeof(entry.length));
+                    position += minEntrySize + nameLength;
+
+                    //the payload lies between the header and the index, compared without adding the offset and the length
+                    check(input && entry.offset >= serializedHeader.size() && entry.offset <= trailer.indexOffset
+                          && entry.length <= trailer.indexOffset - entry.offset, "model offset or length");
+
+                    entryIndices[entry.name] = entries.size();
+                    entries.push_back(entry);
+                }
+
+                check(position == indexEnd, "index size");
+            }
+
+            //checks the trailer of the file without reading the index
+            static bool isContainer(const std::string& filename) {
+                std::ifstream input(filename, std::ios::binary);
+                Trailer trailer;
+                uint64_t size;
+                return input && readTrailer(input, trailer, size);
+            }
+
+            const CompressionHeader& getHeader() const {
+                return header;
+            }
+
+            const std::vector<Entry>& getEntries() const {
+                return entries;
+            }
+
+            //maps the whole container into memory, afterwards the models are read from the mapping instead of seeking in the file
+            void map() {
+                if (mapping == nullptr) {
+                    mapping = std::make_unique<MappedFile>(filename.c_str(), false);
+                }
+            }
+
+            //returns the compressed model including the header, so it has the same content as a single compressed model file
+            std::string read(const Entry& entry) {
+                std::string compressedModel = header.serialize();
+                std::size_t headerSize = compressedModel.size();
+                compressedModel.resize(headerSize + entry.length);
+
+                if (mapping != nullptr) {
+                    std::memcpy(compressedModel.data() + headerSize, mapping->data() + entry.offset, entry.length);
+                } else {
+                    input.seekg(entry.offset);
+                    input.read(compressedModel.data() + headerSize, entry.length);
+                }
+
+                return compressedModel;
+            }
+
+            std::string read(const std::string& name) {
+                auto it = entryIndices.find(name);
+                if (it == entryIndices.end()) {
+                    throw std::runtime_error("The model " + name + " is not contained in " + filename);
+                }
+
+                return read(entries[it->second]);
+            }
+    };
+}
+
+#endif
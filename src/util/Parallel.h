@@ -0,0 +1,107 @@
+#ifndef SRC_UTIL_PARALLEL_H
+#define SRC_UTIL_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+//splits index ranges between threads. The chunks only depend on the size and the number of threads,
+//so passes over the same range see the same chunks and the results can be combined in a deterministic order
+namespace Parallel {
+
+    inline std::size_t chunkBegin(std::size_t size, unsigned int nrThreads, unsigned int chunk) {
+        return size / nrThreads * chunk + std::min<std::size_t>(chunk, size % nrThreads);
+    }
+
+    //the chunk that contains the index, the first size % nrThreads chunks are one element larger than the others
+    inline unsigned int chunkOf(std::size_t size, unsigned int nrThreads, std::size_t index) {
+        std::size_t smallSize = size / nrThreads;
+        std::size_t largeEnd = (smallSize + 1) * (size % nrThreads);
+
+        if (index < largeEnd) {
+            return index / (smallSize + 1);
+        }
+
+        return size % nrThreads + (index - largeEnd) / smallSize;
+    }
+
+    //calls function(chunk, begin, end) for every chunk of [0, size), one thread per chunk.
+    //Exceptions are rethrown in the calling thread after all threads are finished
+    template<typename Function>
+    void forChunks(std::size_t size, unsigned int nrThreads, Function function) {
+        if (nrThreads <= 1) {
+            function(0u, static_cast<std::size_t>(0), size);
+            return;
+        }
+
+        std::vector<std::exception_ptr> errors(nrThreads);
+        std::vector<std::thread> threads;
+
+        for (unsigned int i = 0; i < nrThreads; i++) {
+            threads.emplace_back([&, i]() {
+                try {
+                    function(i, chunkBegin(size, nrThreads, i), chunkBegin(size, nrThreads, i + 1));
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+
+        for (std::thread& thread: threads) {
+            thread.join();
+        }
+
+        for (std::exception_ptr error: errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    //calls function(index) for every index of [0, size). Every thread takes the next index when it is finished with the last one,
+    //so tasks of different lengths are balanced. Exceptions are rethrown in the calling thread after all threads are finished
+    template<typename Function>
+    void forEach(std::size_t size, unsigned int nrThreads, Function function) {
+        if (nrThreads <= 1 || size <= 1) {
+            for (std::size_t i = 0; i < size; i++) {
+                function(i);
+            }
+            return;
+        }
+
+        nrThreads = std::min<std::size_t>(nrThreads, size);
+
+        std::atomic<std::size_t> next(0);
+        std::vector<std::exception_ptr> errors(nrThreads);
+        std::vector<std::thread> threads;
+
+        for (unsigned int i = 0; i < nrThreads; i++) {
+            threads.emplace_back([&, i]() {
+                try {
+                    for (std::size_t index = next++; index < size; index = next++) {
+                        function(index);
+                    }
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                    //the other threads stop after their current task
+                    next = size;
+                }
+            });
+        }
+
+        for (std::thread& thread: threads) {
+            thread.join();
+        }
+
+        for (std::exception_ptr error: errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+}
+
+#endif
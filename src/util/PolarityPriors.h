@@ -0,0 +1,140 @@
+#ifndef SRC_UTIL_POLARITYPRIORS_H_
+#define SRC_UTIL_POLARITYPRIORS_H_
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "SATTypes.h"
+#include "Hash.h"
+
+//polarity priors of a formula that were trained on existing models of the formula. A variable that is assigned to the same value
+//in most of the models is predicted with this value instead of the polarity of the heuristic, the other variables keep the prediction
+//of the heuristic. The priors are stored in a side file with the original ids of the formula. Every model that is compressed in this
+//mode starts with the hash of the side file, the hash is zero if the model was compressed without priors
+struct PolarityPriors {
+    static constexpr const char* MAGIC = "PMP";
+    static constexpr uint8_t VERSION = 1;
+    //magic, version, hash of the formula file, number of variables and number of models
+    static constexpr std::size_t HEADER_SIZE = 20;
+
+    //hash of the content of the formula file the priors were trained for
+    uint64_t formulaHash = 0;
+    uint32_t nrModels = 0;
+    //the majority value of every variable, open if the variable has no prior
+    std::vector<Assignment> values;
+    //hash of the whole side file
+    uint64_t hash = 0;
+
+    //every value is stored in two bits
+    std::string serialize() const {
+        std::string output(MAGIC, 3);
+        output.push_back(static_cast<char>(VERSION));
+        output.append(reinterpret_cast<const char*>(&formulaHash), sizeof(formulaHash));
+
+        uint32_t nrVariables = values.size();
+        output.append(reinterpret_cast<const char*>(&nrVariables), sizeof(nrVariables));
+        output.append(reinterpret_cast<const char*>(&nrModels), sizeof(nrModels));
+
+        std::string packed((values.size() + 3) / 4, 0);
+        for (std::size_t i = 0; i < values.size(); i++) {
+            packed[i / 4] |= static_cast<char>(values[i] << (2 * (i % 4)));
+        }
+        output.append(packed);
+
+        return output;
+    }
+
+    static PolarityPriors parse(const std::string& input) {
+        if (input.size() < HEADER_SIZE || input.compare(0, 3, MAGIC) != 0 || static_cast<uint8_t>(input[3]) != VERSION) {
+            throw std::runtime_error("The file is not a polarity priors file or was created by an older version.");
+        }
+
+        PolarityPriors priors;
+        uint32_t nrVariables;
+        std::memcpy(&priors.formulaHash, input.data() + 4, sizeof(priors.formulaHash));
+        std::memcpy(&nrVariables, input.data() + 12, sizeof(nrVariables));
+        std::memcpy(&priors.nrModels, input.data() + 16, sizeof(priors.nrModels));
+
+        if (input.size() != HEADER_SIZE + (static_cast<std::size_t>(nrVariables) + 3) / 4) {
+            throw std::runtime_error("The polarity priors file is corrupted.");
+        }
+
+        priors.values.reserve(nrVariables);
+        for (std::size_t i = 0; i < nrVariables; i++) {
+            unsigned int value = (static_cast<uint8_t>(input[HEADER_SIZE + i / 4]) >> (2 * (i % 4))) & 3;
+
+            if (value > Assignment::OPEN) {
+                throw std::runtime_error("The polarity priors file is corrupted.");
+            }
+
+            priors.values.push_back(static_cast<Assignment>(value));
+        }
+
+        priors.hash = Hash::xxh64(input.data(), input.size());
+
+        return priors;
+    }
+
+    static PolarityPriors read(const std::string& filename) {
+        std::ifstream input(filename, std::ios::binary);
+        if (!input) {
+            throw std::runtime_error("Could not open the polarity priors file " + filename + ".");
+        }
+
+        std::stringstream buffer;
+        buffer << input.rdbuf();
+        return parse(buffer.str());
+    }
+
+    void write(const std::string& filename) const {
+        std::ofstream output(filename, std::ios::binary);
+        std::string content = serialize();
+        output.write(content.data(), content.size());
+    }
+
+    //the priors can only be used for the formula they were trained for
+    void check(uint64_t formulaFileHash, const std::string& formulaFile) const {
+        if (formulaHash != formulaFileHash) {
+            throw std::runtime_error("The polarity priors were trained for a different formula than " + formulaFile + ".");
+        }
+    }
+
+    //the priors with the ids of the prepared formula, the original ids are empty if the formula was not renumbered
+    std::vector<Assignment> prepare(const std::vector<unsigned int>& originalIds) const {
+        if (originalIds.empty()) {
+            return values;
+        }
+
+        std::vector<Assignment> prepared(originalIds.size(), Assignment::OPEN);
+        for (std::size_t i = 0; i < originalIds.size(); i++) {
+            if (originalIds[i] <= values.size()) {
+                prepared[i] = values[originalIds[i] - 1];
+            }
+        }
+
+        return prepared;
+    }
+
+    static std::string serializeHash(uint64_t hash) {
+        return std::string(reinterpret_cast<const char*>(&hash), sizeof(hash));
+    }
+
+    //removes the hash of the priors from the front of the compressed data and returns it
+    static uint64_t parseHash(std::string& payload) {
+        uint64_t hash;
+        if (payload.size() < sizeof(hash)) {
+            throw std::runtime_error("The hash of the polarity priors is missing in the compressed model.");
+        }
+
+        std::memcpy(&hash, payload.data(), sizeof(hash));
+        payload.erase(0, sizeof(hash));
+
+        return hash;
+    }
+};
+
+#endif
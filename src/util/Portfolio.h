@@ -0,0 +1,118 @@
+#ifndef SRC_UTIL_PORTFOLIO_H_
+#define SRC_UTIL_PORTFOLIO_H_
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <stdexcept>
+
+#include "CompressionHeader.h"
+
+//heuristics of the portfolio mode. Every model is compressed with all heuristics of the portfolio and the smallest result is kept.
+//The id of its heuristic is stored in one byte behind the hashes of the reference and the priors, so the decompression replays
+//the model with the same heuristic without a parameter. The codecs are chosen the same way for every encoded stream, the id of
+//the codec is stored in one byte in front of the stream
+namespace Portfolio {
+
+    //the id of a heuristic is its position in this list, new heuristics are only appended
+    const std::vector<std::string> HEURISTICS = {"none", "jewa", "jewa_dyn", "moms", "moms_dyn", "hybr", "hybr_dyn"};
+
+    inline uint8_t heuristicId(const std::string& heuristic) {
+        for (std::size_t i = 0; i < HEURISTICS.size(); i++) {
+            if (HEURISTICS[i] == heuristic) {
+                return i;
+            }
+        }
+
+        throw std::runtime_error("Unknown heuristic: " + heuristic);
+    }
+
+    inline const std::string& heuristicName(uint8_t id) {
+        if (id >= HEURISTICS.size()) {
+            throw std::runtime_error("Unknown heuristic id in the compressed model: " + std::to_string(id));
+        }
+
+        return HEURISTICS[id];
+    }
+
+    //reads a comma separated list of heuristics
+    inline std::vector<std::string> parseHeuristics(const std::string& list) {
+        std::vector<std::string> heuristics;
+        std::stringstream stream(list);
+        std::string heuristic;
+
+        while (std::getline(stream, heuristic, ',')) {
+            heuristicId(heuristic);
+            heuristics.push_back(heuristic);
+        }
+
+        if (heuristics.empty()) {
+            throw std::runtime_error("The portfolio contains no heuristic.");
+        }
+
+        return heuristics;
+    }
+
+    inline std::string serializeHeuristic(const std::string& heuristic) {
+        return std::string(1, static_cast<char>(heuristicId(heuristic)));
+    }
+
+    //removes the heuristic from the front of the compressed data and returns it, the hashes in front of it must be removed before
+    inline const std::string& parseHeuristic(std::string& payload) {
+        if (payload.empty()) {
+            throw std::runtime_error("The heuristic of the portfolio is missing in the compressed model.");
+        }
+
+        uint8_t id = static_cast<uint8_t>(payload[0]);
+        payload.erase(0, 1);
+
+        return heuristicName(id);
+    }
+
+    //returns the heuristic of a compressed model without removing it, the payload still starts with the hashes
+    inline const std::string& peekHeuristic(const CompressionHeader& header, const std::string& payload) {
+        std::size_t position = (header.hasFlag(CompressionHeader::REFERENCE) ? sizeof(uint64_t) : 0) + (header.hasFlag(CompressionHeader::PRIORS) ? sizeof(uint64_t) : 0);
+
+        if (payload.size() <= position) {
+            throw std::runtime_error("The heuristic of the portfolio is missing in the compressed model.");
+        }
+
+        return heuristicName(static_cast<uint8_t>(payload[position]));
+    }
+
+    //the id of a codec is its position in this list, new codecs are only appended
+    const std::vector<std::string> CODECS = {"golrice", "zip", "lz4"};
+
+    inline uint8_t codecId(const std::string& codec) {
+        for (std::size_t i = 0; i < CODECS.size(); i++) {
+            if (CODECS[i] == codec) {
+                return i;
+            }
+        }
+
+        throw std::runtime_error("Unknown compression algorithm: " + codec);
+    }
+
+    inline const std::string& codecName(uint8_t id) {
+        if (id >= CODECS.size()) {
+            throw std::runtime_error("Unknown codec id in the compressed model: " + std::to_string(id));
+        }
+
+        return CODECS[id];
+    }
+
+    inline std::string serializeCodec(const std::string& codec) {
+        return std::string(1, static_cast<char>(codecId(codec)));
+    }
+
+    //returns the codec of an encoded stream, the stream starts with its id
+    inline const std::string& parseCodec(const std::string& stream) {
+        if (stream.empty()) {
+            throw std::runtime_error("The codec is missing in the compressed model.");
+        }
+
+        return codecName(static_cast<uint8_t>(stream[0]));
+    }
+}
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef SRC_UTIL_REFERENCEMODEL_H_
+#define SRC_UTIL_REFERENCEMODEL_H_
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <stdexcept>
+
+#include "SATTypes.h"
+#include "Hash.h"
+
+//reference model of an instance. The other models of the instance are predicted from the values of the reference instead of the
+//polarity of the heuristic, so their bitvectors only mark the variables in which they differ from the reference. Every model that
+//is compressed in this mode starts with the hash of its compressed reference, the hash is zero if the model was compressed without one
+struct ReferenceModel {
+    //values of the decompressed reference with the ids of the prepared formula, the don't care variables are open
+    std::vector<Assignment> values;
+    //hash of the whole compressed reference
+    uint64_t hash = 0;
+
+    explicit ReferenceModel(std::vector<Assignment> values, const std::string& compressedReference)
+        : values(std::move(values)), hash(Hash::xxh64(compressedReference.data(), compressedReference.size())) {}
+
+    static std::string serializeHash(uint64_t hash) {
+        return std::string(reinterpret_cast<const char*>(&hash), sizeof(hash));
+    }
+
+    //removes the hash of the reference from the front of the compressed data and returns it
+    static uint64_t parseHash(std::string& payload) {
+        uint64_t hash;
+        if (payload.size() < sizeof(hash)) {
+            throw std::runtime_error("The hash of the reference model is missing in the compressed model.");
+        }
+
+        std::memcpy(&hash, payload.data(), sizeof(hash));
+        payload.erase(0, sizeof(hash));
+
+        return hash;
+    }
+};
+
+#endif
@@ -55,7 +55,7 @@ namespace StringCompression {
         return decompressedString;
     }
 
-    std::vector<char> golombRiceCompression(std::vector<uint32_t> input, unsigned int parameter) {
+    std::vector<char> golombRiceCompression(const std::vector<uint32_t>& input, unsigned int parameter) {
         uint32_t moduloBitMask = UINT32_MAX >> (32 - parameter);
         std::vector<char> output;
         uint32_t offset = 0;
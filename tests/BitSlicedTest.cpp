@@ -0,0 +1,145 @@
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <random>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+namespace fs = std::filesystem;
+
+//compresses a batch of models of one formula with the bit-sliced search and with the search of a single model and compares the bytes
+//of every compressed model. Usage: bitSlicedTest <compression executable>
+
+const unsigned int NR_VARIABLES = 300;
+//more models than lanes, so that the batch is split into two groups
+const unsigned int NR_MODELS = 70;
+
+unsigned int failures = 0;
+
+std::string readFile(const fs::path& path) {
+    std::ifstream input(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+}
+
+std::string literal(unsigned int id, bool value) {
+    return value ? std::to_string(id) : "-" + std::to_string(id);
+}
+
+//every clause contains a literal of the shared variables that is true in all models, the other literals are random or false in all models.
+//The long clauses have most of their literals false before they are satisfied, a clause with a duplicated literal counts it twice
+void writeInstance(const fs::path& formulaDirectory, const fs::path& modelDirectory) {
+    std::mt19937 random(1);
+    std::vector<bool> base(NR_VARIABLES + 1);
+    std::vector<unsigned int> shared;
+
+    for (unsigned int id = 1; id <= NR_VARIABLES; id++) {
+        base[id] = random() % 2 == 0;
+        if (random() % 2 == 0) {
+            shared.push_back(id);
+        }
+    }
+
+    auto sharedLiteral = [&](bool value) {
+        unsigned int id = shared[random() % shared.size()];
+        return literal(id, base[id] == value);
+    };
+
+    std::vector<std::string> clauses;
+    for (unsigned int i = 0; i < 1500; i++) {
+        std::string clause = literal(random() % NR_VARIABLES + 1, random() % 2 == 0) + " " + literal(random() % NR_VARIABLES + 1, random() % 2 == 0);
+        clauses.push_back(clause + " " + sharedLiteral(true));
+    }
+    for (unsigned int i = 0; i < 40; i++) {
+        std::string clause;
+        for (unsigned int j = random() % 60 + 20; j > 0; j--) {
+            clause += sharedLiteral(false) + " ";
+        }
+        clauses.push_back(clause + sharedLiteral(true));
+    }
+    for (unsigned int i = 0; i < 20; i++) {
+        std::string falseLiteral = sharedLiteral(false);
+        clauses.push_back(falseLiteral + " " + falseLiteral + " " + sharedLiteral(false) + " " + sharedLiteral(true));
+    }
+
+    std::ofstream formula(formulaDirectory / "instance.cnf");
+    formula << "p cnf " << NR_VARIABLES << " " << clauses.size() << "\n";
+    for (const std::string& clause: clauses) {
+        formula << clause << " 0\n";
+    }
+
+    fs::create_directories(modelDirectory / "instance");
+    for (unsigned int i = 0; i < NR_MODELS; i++) {
+        std::ofstream model(modelDirectory / "instance" / ("model" + std::to_string(i)));
+        model << "s SATISFIABLE\nv";
+
+        for (unsigned int id = 1; id <= NR_VARIABLES; id++) {
+            bool isShared = std::find(shared.begin(), shared.end(), id) != shared.end();
+            model << " " << literal(id, isShared ? base[id] : random() % 2 == 0);
+        }
+
+        model << " 0\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "Usage: bitSlicedTest <compression executable>" << std::endl;
+        return 1;
+    }
+
+    fs::path directory = fs::temp_directory_path() / "modelCompressionBitSlicedTest";
+    fs::remove_all(directory);
+    fs::create_directories(directory / "formulas");
+    writeInstance(directory / "formulas", directory / "models");
+
+    for (std::string heuristic: {"jewa", "moms", "hybr"}) {
+        for (std::string options: {"", " -f"}) {
+            std::string name = heuristic + options;
+            fs::path singleOutput = directory / "single";
+            fs::path bitSlicedOutput = directory / "bitSliced";
+            fs::path log = directory / "bitSliced.log";
+            fs::remove_all(singleOutput);
+            fs::remove_all(bitSlicedOutput);
+            fs::create_directories(singleOutput);
+            fs::create_directories(bitSlicedOutput);
+
+            std::string command = std::string(argv[1]) + " " + (directory / "formulas").string() + " " + (directory / "models").string() + " ";
+            std::string arguments = " -h " + heuristic + options;
+
+            if (std::system((command + singleOutput.string() + arguments + " > /dev/null").c_str()) != 0 ||
+                std::system((command + bitSlicedOutput.string() + arguments + " --bit-sliced > " + log.string()).c_str()) != 0) {
+                std::cerr << "FAILED: the compression with " << name << " did not finish" << std::endl;
+                failures += 1;
+                continue;
+            }
+
+            //the fallback to the single search would hide differences of the lanes
+            std::string output = readFile(log);
+            if (output.find("Compressed 64 of 64 models in the bit-sliced search") == std::string::npos ||
+                output.find("Compressed 6 of 6 models in the bit-sliced search") == std::string::npos) {
+                std::cerr << "FAILED: models with " << name << " were not compressed in the bit-sliced search" << std::endl;
+                failures += 1;
+            }
+
+            for (unsigned int i = 0; i < NR_MODELS; i++) {
+                fs::path model = fs::path("instance") / ("model" + std::to_string(i));
+
+                if (!fs::exists(singleOutput / model) || readFile(singleOutput / model) != readFile(bitSlicedOutput / model)) {
+                    std::cerr << "FAILED: " << model.string() << " with " << name << " differs from the single search" << std::endl;
+                    failures += 1;
+                }
+            }
+        }
+    }
+
+    fs::remove_all(directory);
+
+    if (failures != 0) {
+        return 1;
+    }
+
+    std::cout << "All bit-sliced tests passed." << std::endl;
+    return 0;
+}
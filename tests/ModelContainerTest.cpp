@@ -0,0 +1,108 @@
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <vector>
+#include <string>
+
+#include "ModelContainer.h"
+#include "CompressionHeader.h"
+
+namespace fs = std::filesystem;
+
+unsigned int failures = 0;
+
+std::string readFile(const fs::path& path) {
+    std::ifstream input(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const fs::path& path, const std::string& content) {
+    std::ofstream(path, std::ios::binary) << content;
+}
+
+template<typename T>
+void overwrite(std::string& content, std::size_t position, T value) {
+    std::memcpy(content.data() + position, &value, sizeof(value));
+}
+
+//a corrupted container has to throw a runtime error before anything is allocated for the values it read
+void expectCorrupted(const fs::path& path, const std::string& content, const std::string& name) {
+    writeFile(path, content);
+
+    try {
+        ModelContainer::Reader reader(path.string());
+        std::cerr << "FAILED: " << name << " was read without an error" << std::endl;
+        failures += 1;
+    } catch (const std::runtime_error&) {
+    } catch (const std::exception& e) {
+        std::cerr << "FAILED: " << name << " threw " << e.what() << " instead of a runtime error" << std::endl;
+        failures += 1;
+    }
+}
+
+int main() {
+    fs::path containerPath = fs::temp_directory_path() / "modelCompressionContainerTest.pmc";
+    fs::path corruptedPath = fs::temp_directory_path() / "modelCompressionContainerTestCorrupted.pmc";
+
+    std::string header = CompressionHeader(0x1234, 0).serialize();
+    std::vector<std::pair<std::string, std::string>> models = {{"first", "payload of the first model"}, {"second", "second"}};
+
+    {
+        ModelContainer::Writer writer(containerPath.string());
+        for (const auto& [name, payload]: models) {
+            writer.add(name, header + payload);
+        }
+    }
+
+    ModelContainer::Reader reader(containerPath.string());
+    if (reader.getEntries().size() != models.size()) {
+        std::cerr << "FAILED: the container has " << reader.getEntries().size() << " entries" << std::endl;
+        failures += 1;
+    }
+
+    for (const auto& [name, payload]: models) {
+        if (reader.read(name) != header + payload) {
+            std::cerr << "FAILED: the model " << name << " was not read back" << std::endl;
+            failures += 1;
+        }
+    }
+
+    std::string container = readFile(containerPath);
+    std::size_t trailerPosition = container.size() - sizeof(ModelContainer::Trailer);
+    std::size_t indexOffset = header.size() + models[0].second.size() + models[1].second.size();
+    //the offset of the first entry follows its name length and its name
+    std::size_t entryOffsetPosition = indexOffset + sizeof(uint32_t) + models[0].first.size();
+
+    //the index is cut off, the trailer is kept at the end of the file
+    expectCorrupted(corruptedPath, container.substr(0, indexOffset + 3) + container.substr(trailerPosition), "truncated index");
+
+    std::string corrupted = container;
+    overwrite<uint64_t>(corrupted, trailerPosition + offsetof(ModelContainer::Trailer, nrEntries), std::numeric_limits<uint64_t>::max() / 2);
+    expectCorrupted(corruptedPath, corrupted, "number of entries");
+
+    corrupted = container;
+    overwrite<uint64_t>(corrupted, trailerPosition + offsetof(ModelContainer::Trailer, indexOffset), container.size() + 100);
+    expectCorrupted(corruptedPath, corrupted, "index offset");
+
+    corrupted = container;
+    overwrite<uint32_t>(corrupted, indexOffset, std::numeric_limits<uint32_t>::max());
+    expectCorrupted(corruptedPath, corrupted, "name length");
+
+    //offset and length only overflow if they are added
+    corrupted = container;
+    overwrite<uint64_t>(corrupted, entryOffsetPosition, std::numeric_limits<uint64_t>::max() - 4);
+    overwrite<uint64_t>(corrupted, entryOffsetPosition + sizeof(uint64_t), 8);
+    expectCorrupted(corruptedPath, corrupted, "model offset");
+
+    fs::remove(containerPath);
+    fs::remove(corruptedPath);
+
+    if (failures != 0) {
+        return 1;
+    }
+
+    std::cout << "All model container tests passed." << std::endl;
+    return 0;
+}
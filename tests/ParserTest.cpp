@@ -0,0 +1,129 @@
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <string>
+
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+
+#include "Parser.h"
+#include "SATTypes.h"
+
+namespace fs = std::filesystem;
+
+//comment lines before the header, between the clauses and between the literals of a clause
+const std::string FORMULA =
+    "c first comment\n"
+    "c second comment\n"
+    "p cnf 4 3\n"
+    "1 -2 0\n"
+    "c between clauses\n"
+    "2 3\n"
+    "c inside a clause\n"
+    "-4 0\n"
+    "c before the last clause\n"
+    "-1 4 0\n";
+
+const std::vector<std::vector<int>> EXPECTED = {{1, -2}, {2, 3, -4}, {-1, 4}};
+
+unsigned int failures = 0;
+
+void check(const std::vector<Cl>& clauses, const std::vector<std::vector<int>>& expected, const std::string& name) {
+    std::vector<std::vector<int>> literals;
+    for (const Cl& clause: clauses) {
+        literals.emplace_back();
+        for (Lit lit: clause.literals) {
+            literals.back().push_back(lit.negative ? -static_cast<int>(lit.id) : static_cast<int>(lit.id));
+        }
+    }
+
+    if (literals != expected) {
+        std::cerr << "FAILED: " << name << " parsed " << literals.size() << " clauses" << std::endl;
+        failures += 1;
+    }
+}
+
+//a formula that is larger than the buffer of the stream, so that comments and clauses span the refills of the buffer
+std::string largeFormula(std::vector<std::vector<int>>& expected) {
+    std::string formula = "c generated formula\np cnf 1000 5000\n";
+
+    for (int i = 0; i < 5000; i++) {
+        std::vector<int> clause = {i % 1000 + 1, -((i * 7) % 1000 + 1), (i * 13) % 1000 + 1};
+        expected.push_back(clause);
+
+        formula += std::to_string(clause[0]) + " " + std::to_string(clause[1]);
+        formula += i % 7 == 0 ? "\nc comment inside clause " + std::to_string(i) + "\n" : " ";
+        formula += std::to_string(clause[2]) + " 0\n";
+
+        if (i % 11 == 0) {
+            formula += "c comment between clauses " + std::to_string(i) + "\n\n";
+        }
+    }
+
+    return formula;
+}
+
+void writeGzip(const fs::path& path, const std::string& content) {
+    std::ofstream file(path, std::ios::binary);
+    boost::iostreams::filtering_ostream output;
+    output.push(boost::iostreams::gzip_compressor());
+    output.push(file);
+    output << content;
+}
+
+int main() {
+    fs::path formulaPath = fs::temp_directory_path() / "modelCompressionParserTest.cnf";
+    std::ofstream(formulaPath) << FORMULA;
+    std::string formulaFile(formulaPath);
+
+    Parser parser(formulaFile.c_str(), nullptr);
+    check(parser.readClauses(), EXPECTED, "readClauses");
+
+    //every chunk boundary lies on a different line with more threads than lines
+    for (unsigned int nrThreads: {2, 3, 4, 16}) {
+        check(parser.readClausesParallel(nrThreads), EXPECTED, "readClausesParallel(" + std::to_string(nrThreads) + ")");
+    }
+
+    if (parser.readVariables().size() != 4) {
+        std::cerr << "FAILED: readVariables" << std::endl;
+        failures += 1;
+    }
+
+    //the content of a formula from an archive is parsed the same way
+    Parser memoryParser("memory.cnf", nullptr);
+    memoryParser.setFormulaContent(&FORMULA);
+    check(memoryParser.readClauses(), EXPECTED, "readClauses from memory");
+    check(memoryParser.readClausesParallel(3), EXPECTED, "readClausesParallel from memory");
+
+    //the sequential parser streams the file, the parallel parser maps it or decompresses it into memory
+    std::vector<std::vector<int>> largeExpected;
+    std::string large = largeFormula(largeExpected);
+    fs::path largePath = fs::temp_directory_path() / "modelCompressionParserTestLarge.cnf";
+    fs::path compressedPath = fs::temp_directory_path() / "modelCompressionParserTestLarge.cnf.gz";
+    std::ofstream(largePath) << large;
+    writeGzip(compressedPath, large);
+
+    for (const fs::path& path: {largePath, compressedPath}) {
+        std::string file(path);
+        Parser largeParser(file.c_str(), nullptr);
+        check(largeParser.readClauses(), largeExpected, "readClauses of " + path.filename().string());
+        check(largeParser.readClausesParallel(4), largeExpected, "readClausesParallel(4) of " + path.filename().string());
+
+        if (largeParser.readVariables().size() != 1000) {
+            std::cerr << "FAILED: readVariables of " << path.filename().string() << std::endl;
+            failures += 1;
+        }
+    }
+
+    fs::remove(formulaPath);
+    fs::remove(largePath);
+    fs::remove(compressedPath);
+
+    if (failures != 0) {
+        return 1;
+    }
+
+    std::cout << "All parser tests passed." << std::endl;
+    return 0;
+}